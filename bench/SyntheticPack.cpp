@@ -0,0 +1,283 @@
+#include "SyntheticPack.h"
+#include "IconAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // splitmix64: tiny, and identical on every platform / standard library.
+    struct Rng
+    {
+        uint64_t state;
+
+        uint64_t Next()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        float Uniform(float lo, float hi)
+        {
+            return lo + (hi - lo) * (float)(Next() >> 40) * (1.f / 16777216.f);
+        }
+    };
+
+    void Append(std::string& out, const char* fmt, ...)
+    {
+        char buf[512];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n > 0) out.append(buf, std::min((size_t)n, sizeof(buf) - 1));
+    }
+
+    // TacO GUIDs are 16 random bytes, base64.
+    std::string Guid(Rng& rng)
+    {
+        static const char kDigits[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        uint8_t bytes[18] = {};
+        uint64_t a = rng.Next(), b = rng.Next();
+        memcpy(bytes, &a, 8);
+        memcpy(bytes + 8, &b, 8);
+
+        std::string out;
+        for (int i = 0; i < 18; i += 3)
+        {
+            uint32_t v = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+            out += kDigits[(v >> 18) & 63];
+            out += kDigits[(v >> 12) & 63];
+            out += kDigits[(v >> 6) & 63];
+            out += kDigits[v & 63];
+        }
+        out.resize(22);
+        return out + "==";
+    }
+
+    std::vector<uint8_t> Bytes(const std::string& s) { return { s.begin(), s.end() }; }
+
+    // A soft-edged disc in a colour of its own, on a transparent square.
+    std::vector<uint8_t> MakeIcon(uint32_t index)
+    {
+        IconAtlas::Page img;
+        img.size = 32 + 16 * (int)(index % 3);
+        img.rgba.resize((size_t)img.size * img.size * 4);
+
+        const float hue = (float)index * 0.618034f;   // golden ratio steps
+        const float r = 0.5f + 0.5f * std::cos(6.2831853f * hue);
+        const float g = 0.5f + 0.5f * std::cos(6.2831853f * (hue - 0.3333333f));
+        const float b = 0.5f + 0.5f * std::cos(6.2831853f * (hue - 0.6666667f));
+        const float c = 0.5f * (float)img.size, radius = c - 1.f;
+        for (int y = 0; y < img.size; ++y)
+        {
+            for (int x = 0; x < img.size; ++x)
+            {
+                const float d = std::hypot((float)x + 0.5f - c, (float)y + 0.5f - c);
+                const float a = std::clamp(radius - d, 0.f, 1.f);
+                const float shade = 1.f - 0.5f * d / radius;
+                uint8_t* px = &img.rgba[((size_t)y * img.size + x) * 4];
+                px[0] = (uint8_t)(255.f * r * shade);
+                px[1] = (uint8_t)(255.f * g * shade);
+                px[2] = (uint8_t)(255.f * b * shade);
+                px[3] = (uint8_t)(255.f * a);
+            }
+        }
+
+        std::vector<uint8_t> png;
+        IconAtlas::EncodePng(img, png);
+        return png;
+    }
+
+    // Chevrons pointing up the texture (along the trail).
+    std::vector<uint8_t> MakeTrailTexture()
+    {
+        IconAtlas::Page img;
+        img.size = 64;
+        img.rgba.resize((size_t)img.size * img.size * 4);
+        for (int y = 0; y < img.size; ++y)
+        {
+            for (int x = 0; x < img.size; ++x)
+            {
+                const int  v  = (y + std::abs(x - img.size / 2)) % 32;
+                uint8_t*   px = &img.rgba[((size_t)y * img.size + x) * 4];
+                px[0] = 255; px[1] = 255; px[2] = 255;
+                px[3] = v < 12 ? 230 : 90;
+            }
+        }
+
+        std::vector<uint8_t> png;
+        IconAtlas::EncodePng(img, png);
+        return png;
+    }
+
+    std::string IconFile(const SyntheticPack::Options& o, uint64_t leaf)
+    {
+        return "icons/" + std::to_string(leaf % std::max(o.icons, 1u)) + ".png";
+    }
+
+    // One MarkerCategory node and its subtree; leaf counts the leaves
+    // written so far, in the order LeafPath numbers them.
+    void WriteCategory(const SyntheticPack::Options& o, std::string& xml, uint32_t level,
+                       uint32_t index, uint64_t& leaf)
+    {
+        std::string indent(2 * (level + 1), ' ');
+        Append(xml, "%s<MarkerCategory name=\"c%u\" DisplayName=\"Category %u-%u\"",
+               indent.c_str(), index, level, index);
+        if (level == 0)
+            Append(xml, " iconSize=\"%.2f\"", 0.75f + 0.25f * (float)(index % 3));
+
+        if (level + 1 == o.depth)
+        {
+            xml += " iconFile=\"" + IconFile(o, leaf++) + "\"/>\n";
+            return;
+        }
+
+        xml += ">\n";
+        for (uint32_t c = 0; c < o.categories; ++c)
+            WriteCategory(o, xml, level + 1, c, leaf);
+        xml += indent + "</MarkerCategory>\n";
+    }
+
+    // A wandering walk inside the map, one trail binary.
+    std::vector<uint8_t> MakeTrail(Rng& rng, uint32_t mapId, uint32_t pointCount)
+    {
+        constexpr float kHalf = SyntheticPack::kMapExtent * 0.5f;
+        constexpr float kStep = 1.5f;
+
+        std::vector<uint8_t> data(8 + (size_t)pointCount * 12);
+        uint32_t version = 0;
+        memcpy(data.data(), &version, 4);
+        memcpy(data.data() + 4, &mapId, 4);
+
+        float x = rng.Uniform(-kHalf * 0.5f, kHalf * 0.5f);
+        float z = rng.Uniform(-kHalf * 0.5f, kHalf * 0.5f);
+        float y = rng.Uniform(0.f, 50.f);
+        float heading = rng.Uniform(0.f, 6.2831853f);
+        uint8_t* p = data.data() + 8;
+        for (uint32_t i = 0; i < pointCount; ++i, p += 12)
+        {
+            memcpy(p,     &x, 4);
+            memcpy(p + 4, &y, 4);
+            memcpy(p + 8, &z, 4);
+
+            heading += rng.Uniform(-0.2f, 0.2f);
+            x += kStep * std::cos(heading);
+            z += kStep * std::sin(heading);
+            y  = std::clamp(y + rng.Uniform(-0.3f, 0.3f), 0.f, 100.f);
+            if (x < -kHalf || x > kHalf || z < -kHalf || z > kHalf)
+            {
+                heading += 3.1415927f;   // turn back at the map edge
+                x = std::clamp(x, -kHalf, kHalf);
+                z = std::clamp(z, -kHalf, kHalf);
+            }
+        }
+        return data;
+    }
+}
+
+uint64_t SyntheticPack::LeafCount(const Options& o)
+{
+    uint64_t n = 1;
+    for (uint32_t d = 0; d < o.depth; ++d) n *= o.categories;
+    return n;
+}
+
+std::string SyntheticPack::LeafPath(const Options& o, uint64_t leaf)
+{
+    std::string path;
+    uint64_t    span = LeafCount(o);
+    for (uint32_t d = 0; d < o.depth; ++d)
+    {
+        span /= o.categories;
+        if (!path.empty()) path += '.';
+        path += 'c' + std::to_string(leaf / span);
+        leaf %= span;
+    }
+    return path;
+}
+
+void SyntheticPack::Generate(const Options& options, std::vector<File>& out)
+{
+    Generate(options, [&](File&& file) { out.push_back(std::move(file)); });
+}
+
+void SyntheticPack::Generate(const Options& options, const std::function<void(File&&)>& sink)
+{
+    Options o = options;
+    o.categories = std::max(o.categories, 1u);
+    o.depth      = std::max(o.depth, 1u);
+
+    Rng rng{o.seed};
+    const uint64_t leaves = LeafCount(o);
+    constexpr float kHalf = kMapExtent * 0.5f;
+
+    std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<OverlayData>\n";
+    uint64_t leaf = 0;
+    for (uint32_t c = 0; c < o.categories; ++c)
+        WriteCategory(o, xml, 0, c, leaf);
+    xml += "</OverlayData>\n";
+    sink({ "categories.xml", Bytes(xml) });
+
+    for (uint32_t m = 0; m < o.maps; ++m)
+    {
+        const uint32_t mapId = kFirstMapId + m;
+        xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<OverlayData>\n  <POIs>\n";
+        for (uint32_t i = 0; i < o.poisPerMap; ++i)
+        {
+            uint64_t l = ((uint64_t)m * o.poisPerMap + i) % leaves;
+            Append(xml, "    <POI MapID=\"%u\" xpos=\"%.3f\" ypos=\"%.3f\" zpos=\"%.3f\" type=\"%s\" GUID=\"%s\"",
+                   mapId, rng.Uniform(-kHalf, kHalf), rng.Uniform(0.f, 100.f),
+                   rng.Uniform(-kHalf, kHalf), LeafPath(o, l).c_str(), Guid(rng).c_str());
+            // A few markers override an attribute, as real packs do.
+            if (i % 32 == 31) xml += " iconSize=\"1.5\"";
+            xml += "/>\n";
+        }
+        for (uint32_t t = 0; t < o.trailsPerMap; ++t)
+        {
+            std::string file = "trails/" + std::to_string(mapId) + "_" + std::to_string(t) + ".trl";
+            uint64_t l = ((uint64_t)m * o.trailsPerMap + t) % leaves;
+            Append(xml, "    <Trail MapID=\"%u\" type=\"%s\" trailData=\"%s\" texture=\"icons/trail.png\" GUID=\"%s\"/>\n",
+                   mapId, LeafPath(o, l).c_str(), file.c_str(), Guid(rng).c_str());
+            sink({ file, MakeTrail(rng, mapId, o.pointsPerTrail) });
+        }
+        xml += "  </POIs>\n</OverlayData>\n";
+        sink({ "maps/" + std::to_string(mapId) + ".xml", Bytes(xml) });
+    }
+
+    for (uint32_t i = 0; i < std::max(o.icons, 1u); ++i)
+        sink({ "icons/" + std::to_string(i) + ".png", MakeIcon(i) });
+    sink({ "icons/trail.png", MakeTrailTexture() });
+}
+
+const char* const SyntheticPack::kOptionUsage =
+    "[--maps N] [--pois N] [--trails N] [--points N]\n"
+    "          [--categories N] [--depth N] [--icons N] [--seed N]";
+
+bool SyntheticPack::SetOption(Options& o, const char* flag, const char* value)
+{
+    struct Flag { const char* name; uint32_t* field; };
+    const Flag flags[] = {
+        { "--maps",       &o.maps },
+        { "--pois",       &o.poisPerMap },
+        { "--trails",     &o.trailsPerMap },
+        { "--points",     &o.pointsPerTrail },
+        { "--categories", &o.categories },
+        { "--depth",      &o.depth },
+        { "--icons",      &o.icons },
+        { "--seed",       &o.seed },
+    };
+    for (const auto& f : flags)
+    {
+        if (strcmp(flag, f.name) != 0) continue;
+        *f.field = (uint32_t)strtoul(value, nullptr, 10);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SyntheticPack
+//
+// Generates the files of a TacO pack of any size, deterministically from a
+// seed, so the loader / filtering / renderer can be measured without real
+// packs.  Layout of the generated pack:
+//   categories.xml          the MarkerCategory tree (categories children per
+//                           node, depth levels)
+//   maps/<mapId>.xml        one file per map: its POIs and Trails
+//   trails/<mapId>_<n>.trl  trail binaries (version 0, map id, float3 points)
+//   icons/<n>.png           distinct marker icons, 32-64 px
+//   icons/trail.png         the trails' texture
+// Markers reference leaf categories round-robin; leaves use the icons
+// round-robin.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace SyntheticPack
+{
+
+constexpr uint32_t kFirstMapId = 1000;    // maps are kFirstMapId, kFirstMapId + 1, ...
+constexpr float    kMapExtent  = 2000.f;  // markers lie within ±kMapExtent/2 on x / z
+
+struct Options
+{
+    uint32_t categories     = 8;      // children per category
+    uint32_t depth          = 2;      // levels of the tree
+    uint32_t maps           = 4;
+    uint32_t poisPerMap     = 2000;
+    uint32_t trailsPerMap   = 8;
+    uint32_t pointsPerTrail = 1000;
+    uint32_t icons          = 16;     // distinct icon files
+    uint32_t seed           = 1;
+};
+
+struct File
+{
+    std::string          name;        // archive entry name, forward slashes
+    std::vector<uint8_t> data;
+};
+
+// Hands the pack's files to sink one at a time, so even very large packs
+// never have to be held in memory at once.
+void Generate(const Options& options, const std::function<void(File&&)>& sink);
+
+// Appends the pack's files to out.
+void Generate(const Options& options, std::vector<File>& out);
+
+// Command-line form of Options, shared by pathing_bench and taco_gen:
+// "--maps N", "--pois N", ...  SetOption returns false for an unknown flag.
+extern const char* const kOptionUsage;
+bool SetOption(Options& options, const char* flag, const char* value);
+
+// Dotted type path of leaf category i (0 <= i < LeafCount).
+std::string LeafPath(const Options& options, uint64_t leaf);
+uint64_t    LeafCount(const Options& options);
+
+} // namespace SyntheticPack
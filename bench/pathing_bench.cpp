@@ -0,0 +1,384 @@
+// ─────────────────────────────────────────────────────────────────────────────
+// pathing_bench
+//
+// Headless benchmark of the addon's hot paths, built on Linux from the
+// platform-independent sources:
+//   •  XML parse throughput   TacoParser::LoadXmlDocument + both passes
+//   •  trail load throughput  LoadTrailBinaryMemory + ComputeArcLengths
+//   •  per-map lookup         PackManager::FilterPoisForMap / FilterTrailsForMap
+//   •  per-frame geometry     SceneRenderer::Render into an ImGui draw list,
+//                             driven by a scripted camera instead of MumbleLink
+// The pack is generated (SyntheticPack) unless a .taco is given.  The
+// projection and icon atlas are checked by their tests (tests/), not here.
+//
+//   pathing_bench [--taco FILE] [--maps N] [--pois N] [--trails N]
+//                 [--points N] [--categories N] [--depth N] [--icons N]
+//                 [--frames N] [--seed N]
+// ─────────────────────────────────────────────────────────────────────────────
+#include "SyntheticPack.h"
+
+#include "TacoParser.h"
+#include "PackArchive.h"
+#include "PackManager.h"
+#include "SceneRenderer.h"
+#include "Profiler.h"
+#include "Settings.h"
+#include "Platform.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Settings.cpp is addon-only (it persists through Nexus); the bench renders
+// with the defaults.
+Settings g_Settings;
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    double MsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double MBps(uint64_t bytes, double ms)
+    {
+        return ms > 0.0 ? (double)bytes / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0;
+    }
+
+    float Percentile(std::vector<float> v, float p)
+    {
+        if (v.empty()) return 0.f;
+        size_t i = std::min(v.size() - 1, (size_t)(p * (float)(v.size() - 1) + 0.5f));
+        std::nth_element(v.begin(), v.begin() + i, v.end());
+        return v[i];
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Arguments
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace
+{
+    struct Args
+    {
+        SyntheticPack::Options pack;
+        std::string            tacoFile;
+        uint32_t               frames = 600;
+    };
+
+    bool ParseArgs(int argc, char** argv, Args& args)
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            if (strcmp(argv[i], "--taco") == 0)
+                args.tacoFile = argv[i + 1];
+            else if (strcmp(argv[i], "--frames") == 0)
+                args.frames = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+            else if (!SyntheticPack::SetOption(args.pack, argv[i], argv[i + 1]))
+                return false;
+        }
+        args.frames = std::clamp<uint32_t>(args.frames, 1, (uint32_t)Profiler::kHistory);
+        return argc % 2 == 1;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Loading
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace
+{
+    struct LoadStats
+    {
+        uint64_t xmlBytes    = 0;
+        double   xmlMs       = 0.0;
+        uint64_t trailBytes  = 0;
+        uint64_t trailPoints = 0;
+        double   trailMs     = 0.0;
+        double   indexMs     = 0.0;
+    };
+
+    bool HasExtension(const std::string& name, const char* ext)
+    {
+        size_t n = strlen(ext);
+        return name.size() >= n && Platform::CompareNoCase(name.c_str() + name.size() - n, ext) == 0;
+    }
+
+    bool ReadTaco(const std::string& path, std::vector<SyntheticPack::File>& files)
+    {
+        PackArchive archive;
+        if (!archive.Open(path)) return false;
+        for (const auto& entry : archive.Entries())
+        {
+            SyntheticPack::File file;
+            file.name = entry.name;
+            if (archive.Read(entry, file.data)) files.push_back(std::move(file));
+        }
+        return true;
+    }
+
+    // The loader's stages, single-threaded so the throughput figures are per
+    // core: XML documents, trail binaries, then the indices.  Textures are
+    // not decoded; every distinct icon / trail texture just gets a slot.
+    void BuildPack(const std::vector<SyntheticPack::File>& files, TacoPack& pack,
+                   std::vector<void*>& texSlots, LoadStats& stats)
+    {
+        std::unordered_map<std::string, const SyntheticPack::File*> byName;
+        std::vector<const SyntheticPack::File*> xmlFiles;
+        for (const auto& file : files)
+        {
+            byName[TacoParser::NormalisePath(file.name)] = &file;
+            if (HasExtension(file.name, ".xml")) xmlFiles.push_back(&file);
+        }
+
+        std::vector<std::vector<uint8_t>> buffers;
+        for (const auto* file : xmlFiles)
+        {
+            buffers.push_back(file->data);
+            stats.xmlBytes += file->data.size();
+        }
+
+        auto start = Clock::now();
+        std::vector<TacoParser::XmlDocument> docs(buffers.size());
+        for (size_t i = 0; i < buffers.size(); ++i)
+            TacoParser::LoadXmlDocument(std::move(buffers[i]), docs[i]);
+        for (const auto& doc : docs)
+            TacoParser::ParseDocumentCategories(doc, pack);
+        for (const auto& doc : docs)
+            TacoParser::ParseDocumentPois(doc, pack);
+        stats.xmlMs = MsSince(start);
+        docs.clear();
+
+        start = Clock::now();
+        std::vector<Trail> trails;
+        trails.reserve(pack.trails.size());
+        for (auto& trail : pack.trails)
+        {
+            auto it = byName.find(TacoParser::NormalisePath(trail.trailDataFile));
+            if (it == byName.end()) continue;
+            const std::vector<uint8_t>& data = it->second->data;
+            if (!TacoParser::LoadTrailBinaryMemory(data.data(), data.size(), trail)) continue;
+            if (trail.mapId == 0 || trail.points.empty()) continue;
+            TacoParser::ComputeArcLengths(trail);
+            stats.trailBytes  += data.size();
+            stats.trailPoints += trail.points.size();
+            trails.push_back(std::move(trail));
+        }
+        pack.trails = std::move(trails);
+        stats.trailMs = MsSince(start);
+
+        start = Clock::now();
+        for (auto& trail : pack.trails)
+            TacoParser::BuildTrailChunks(trail);
+        pack.IndexCategories();
+        pack.BuildMapIndex();
+        stats.indexMs = MsSince(start);
+
+        std::unordered_map<std::string, uint32_t> slots;
+        auto slotFor = [&](const std::string& file)
+        {
+            if (file.empty()) return kNoTexSlot;
+            auto it = slots.emplace(TacoParser::NormalisePath(file), (uint32_t)slots.size());
+            return it.first->second;
+        };
+        pack.icons.assign(pack.attribs.size(), IconRef{});
+        for (size_t a = 0; a < pack.attribs.size(); ++a)
+            pack.icons[a].texSlot = slotFor(pack.attribs[a].iconFile);
+        for (auto& trail : pack.trails)
+            trail.texSlot = slotFor(pack.AttribsOf(trail).texture);
+
+        // Any non-null value will do: nothing samples these textures.
+        texSlots.resize(slots.size());
+        for (size_t s = 0; s < texSlots.size(); ++s)
+            texSlots[s] = reinterpret_cast<void*>((uintptr_t)(s + 2));
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Fake MumbleLink
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace
+{
+    // Camera for a frame: circling the map's centre at head height, looking
+    // ahead and slightly down, a full lap every kLapFrames frames.
+    SceneRenderer::Camera CameraAt(uint32_t frame, const Math::Vec3& centre, float radius)
+    {
+        constexpr uint32_t kLapFrames = 600;
+        const float angle = 6.2831853f * (float)(frame % kLapFrames) / (float)kLapFrames;
+
+        SceneRenderer::Camera cam;
+        cam.position = centre + Math::Vec3{ radius * std::cos(angle), 25.f, radius * std::sin(angle) };
+        const Math::Vec3 ahead{ -std::sin(angle), -0.25f, std::cos(angle) };
+        cam.front = ahead.Normalised();
+        const Math::Vec3 right = Math::Vec3{ 0.f, 1.f, 0.f }.Cross(cam.front).Normalised();
+        cam.top   = cam.front.Cross(right);
+        cam.fovY  = SceneRenderer::kDefaultFovY;
+        return cam;
+    }
+
+    Math::Vec3 MapCentre(const TacoPack& pack, const MapRange& range)
+    {
+        Math::Vec3 sum;
+        uint32_t   n = 0;
+        for (uint32_t i = range.poiBegin; i < range.poiEnd; ++i, ++n)
+            sum = sum + Math::Vec3{ pack.pois[i].x, pack.pois[i].y, pack.pois[i].z };
+        for (uint32_t i = range.trailBegin; i < range.trailEnd; ++i, ++n)
+        {
+            const Trail& t = pack.trails[i];
+            sum = sum + Math::Vec3{ t.boundsMin.x + t.boundsMax.x, t.boundsMin.y + t.boundsMax.y,
+                                    t.boundsMin.z + t.boundsMax.z } * 0.5f;
+        }
+        return n ? sum * (1.f / (float)n) : sum;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Benchmarks
+// ─────────────────────────────────────────────────────────────────────────────
+
+static void BenchLookup(const std::vector<TacoPack>& packs)
+{
+    constexpr int kRepeats = 64;
+    std::vector<PackManager::PoiView>   pois;
+    std::vector<PackManager::TrailView> trails;
+    std::vector<float>                  us;
+
+    printf("\nPer-map lookup (%d runs per map)\n", kRepeats);
+    printf("  %8s %8s %8s %10s %10s\n", "map", "pois", "trails", "p50 us", "p99 us");
+    for (const MapRange& range : packs[0].mapIndex)
+    {
+        us.clear();
+        for (int r = 0; r < kRepeats; ++r)
+        {
+            auto start = Clock::now();
+            PackManager::FilterPoisForMap(packs, range.mapId, pois);
+            PackManager::FilterTrailsForMap(packs, range.mapId, trails);
+            us.push_back((float)(MsSince(start) * 1000.0));
+        }
+        printf("  %8u %8zu %8zu %10.2f %10.2f\n", range.mapId, pois.size(), trails.size(),
+               Percentile(us, 0.5f), Percentile(us, 0.99f));
+    }
+}
+
+static void BenchFrames(const std::vector<TacoPack>& packs, const std::vector<void*>& texSlots,
+                        uint32_t frames)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.f, 1080.f);
+    io.DeltaTime   = 1.f / 60.f;
+    io.IniFilename = nullptr;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    unsigned char* pixels;
+    int            w, h;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);
+    io.Fonts->TexID = reinterpret_cast<ImTextureID>((uintptr_t)1);
+
+    const TacoPack& pack = packs[0];
+    const uint32_t  maps = (uint32_t)pack.mapIndex.size();
+    const uint32_t  perMap = std::max(1u, frames / std::max(maps, 1u));
+
+    uint64_t vertices = 0, drawn = 0;
+    for (uint32_t f = 0; f < frames && maps; ++f)
+    {
+        const MapRange& range = pack.mapIndex[std::min(f / perMap, maps - 1)];
+
+        SceneRenderer::FrameInput in;
+        in.packs         = &packs;
+        in.generation    = 1;
+        in.mapId         = range.mapId;
+        in.camera        = CameraAt(f, MapCentre(pack, range), 300.f);
+        in.screenW       = io.DisplaySize.x;
+        in.screenH       = io.DisplaySize.y;
+        in.texSlots      = &texSlots;
+        in.solid.texture = io.Fonts->TexID;
+        in.solid.uv      = io.Fonts->TexUvWhitePixel;
+
+        ImGui::NewFrame();
+        ImDrawList* dl = ImGui::GetBackgroundDrawList();
+        Profiler::BeginFrame();
+        {
+            Profiler::ScopedTimer timer(Profiler::Stage::Frame);
+            SceneRenderer::Render(in, dl);
+        }
+        vertices += (uint64_t)dl->VtxBuffer.Size;
+        drawn    += Profiler::LastFunnel().drawn;
+        ImGui::Render();
+    }
+    SceneRenderer::Shutdown();
+    ImGui::DestroyContext();
+
+    Profiler::StageStats stats[Profiler::kStageCount];
+    if (!Profiler::Summarize(stats)) return;
+
+    printf("\nFrame geometry (%u frames over %u map(s), %.0fx%.0f)\n", frames, maps,
+           1920.f, 1080.f);
+    printf("  %-12s %8s %8s %8s %8s\n", "stage", "p50 ms", "p95 ms", "p99 ms", "max ms");
+    for (size_t s = 0; s < Profiler::kStageCount; ++s)
+    {
+        if (s == (size_t)Profiler::Stage::Textures) continue;   // addon only
+        printf("  %-12s %8.3f %8.3f %8.3f %8.3f\n", Profiler::StageName((Profiler::Stage)s),
+               stats[s].p50, stats[s].p95, stats[s].p99, stats[s].max);
+    }
+    printf("  avg %llu markers drawn, %llu vertices per frame\n",
+           (unsigned long long)(drawn / frames), (unsigned long long)(vertices / frames));
+}
+
+int main(int argc, char** argv)
+{
+    Args args;
+    if (!ParseArgs(argc, argv, args))
+    {
+        fprintf(stderr, "usage: %s [--taco FILE] [--frames N]\n          %s\n",
+                argv[0], SyntheticPack::kOptionUsage);
+        return 2;
+    }
+
+    std::vector<SyntheticPack::File> files;
+    if (!args.tacoFile.empty())
+    {
+        if (!ReadTaco(args.tacoFile, files))
+        {
+            fprintf(stderr, "can't open %s\n", args.tacoFile.c_str());
+            return 2;
+        }
+    }
+    else
+    {
+        SyntheticPack::Generate(args.pack, files);
+    }
+
+    std::vector<TacoPack> packs(1);
+    packs[0].name = args.tacoFile.empty() ? "synthetic" : args.tacoFile;
+    std::vector<void*> texSlots;
+    LoadStats load;
+    BuildPack(files, packs[0], texSlots, load);
+    files.clear();
+
+    const TacoPack& pack = packs[0];
+    printf("Pack %s: %zu POIs, %zu trails, %llu trail points, %zu maps, %u categories\n",
+           pack.name.c_str(), pack.pois.size(), pack.trails.size(),
+           (unsigned long long)load.trailPoints, pack.mapIndex.size(), pack.categoryCount);
+    printf("\nLoading (one thread)\n");
+    printf("  XML parse   %10.1f ms %10.1f MB/s\n", load.xmlMs, MBps(load.xmlBytes, load.xmlMs));
+    printf("  trail load  %10.1f ms %10.1f MB/s %10.1f Mpoints/s\n", load.trailMs,
+           MBps(load.trailBytes, load.trailMs),
+           load.trailMs > 0.0 ? (double)load.trailPoints / 1e3 / load.trailMs : 0.0);
+    printf("  indices     %10.1f ms\n", load.indexMs);
+
+    BenchLookup(packs);
+    BenchFrames(packs, texSlots, args.frames);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// ─────────────────────────────────────────────────────────────────────────────
+// taco_gen
+//
+// Writes a synthetic .taco pack (see SyntheticPack) of any size, for scale
+// testing the loader, the per-map filtering and the renderer — in the game
+// (drop it into the packs folder) or with pathing_bench --taco.  Files are
+// compressed into the archive as they are generated, so packs far larger
+// than memory-friendly sizes can be written.
+//
+//   taco_gen OUT.taco [--maps N] [--pois N] [--trails N] [--points N]
+//                     [--categories N] [--depth N] [--icons N] [--seed N]
+// ─────────────────────────────────────────────────────────────────────────────
+#include "SyntheticPack.h"
+
+#include <miniz.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    SyntheticPack::Options options;
+    bool ok = argc >= 2 && argc % 2 == 0;
+    for (int i = 2; ok && i + 1 < argc; i += 2)
+        ok = SyntheticPack::SetOption(options, argv[i], argv[i + 1]);
+    if (!ok)
+    {
+        fprintf(stderr, "usage: %s OUT.taco %s\n", argv[0], SyntheticPack::kOptionUsage);
+        return 2;
+    }
+    const char* path = argv[1];
+
+    mz_zip_archive zip{};
+    if (!mz_zip_writer_init_file(&zip, path, 0))
+    {
+        fprintf(stderr, "can't create %s\n", path);
+        return 1;
+    }
+
+    size_t   files = 0;
+    uint64_t bytes = 0;
+    bool     failed = false;
+    SyntheticPack::Generate(options, [&](SyntheticPack::File&& file)
+    {
+        if (failed) return;
+        // PNGs are deflated already.
+        const mz_uint level = EndsWith(file.name, ".png") ? MZ_NO_COMPRESSION : MZ_DEFAULT_LEVEL;
+        if (!mz_zip_writer_add_mem(&zip, file.name.c_str(), file.data.data(), file.data.size(), level))
+        {
+            fprintf(stderr, "can't add %s: %s\n", file.name.c_str(),
+                    mz_zip_get_error_string(mz_zip_get_last_error(&zip)));
+            failed = true;
+            return;
+        }
+        ++files;
+        bytes += file.data.size();
+    });
+
+    if (!failed && !mz_zip_writer_finalize_archive(&zip))
+    {
+        fprintf(stderr, "can't finish %s: %s\n", path,
+                mz_zip_get_error_string(mz_zip_get_last_error(&zip)));
+        failed = true;
+    }
+    mz_zip_writer_end(&zip);
+    if (failed)
+    {
+        std::remove(path);
+        return 1;
+    }
+
+    const uint64_t leaves = SyntheticPack::LeafCount(options);
+    printf("%s: %zu files, %.1f MB uncompressed\n", path, files, (double)bytes / (1024.0 * 1024.0));
+    printf("  %u map(s) x (%u POIs + %u trails of %u points), %llu leaf categories, %u icons\n",
+           options.maps, options.poisPerMap, options.trailsPerMap, options.pointsPerTrail,
+           (unsigned long long)leaves, options.icons);
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "FramePrep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void GeoBuffer::Clear()
+{
+    vtx.clear();
+    idx.clear();
+    spans.clear();
+}
+
+GeoBuffer::Span& GeoBuffer::SpanFor(ImTextureID texture, uint32_t vtxCount)
+{
+    if (spans.empty() || spans.back().texture != texture ||
+        spans.back().vtxCount + vtxCount > kMaxRunVertices)
+    {
+        Span span;
+        span.texture  = texture;
+        span.vtxBegin = (uint32_t)vtx.size();
+        span.idxBegin = (uint32_t)idx.size();
+        spans.push_back(span);
+    }
+    return spans.back();
+}
+
+void GeoBuffer::AddQuad(ImTextureID texture, const ImVec2 p[4], const ImVec2 uv[4], ImU32 col)
+{
+    Span& span = SpanFor(texture, 4);
+    const uint16_t b = (uint16_t)span.vtxCount;
+    for (int k = 0; k < 4; ++k)
+        vtx.push_back({ p[k].x, p[k].y, uv[k].x, uv[k].y, col });
+
+    const uint16_t quad[6] = { b, (uint16_t)(b + 1), (uint16_t)(b + 2),
+                               b, (uint16_t)(b + 2), (uint16_t)(b + 3) };
+    idx.insert(idx.end(), quad, quad + 6);
+    span.vtxCount += 4;
+    span.idxCount += 6;
+}
+
+void GeoBuffer::AddSolidQuad(const SolidTexture& solid, const ImVec2 p[4], ImU32 col)
+{
+    const ImVec2 uv[4] = { solid.uv, solid.uv, solid.uv, solid.uv };
+    AddQuad(solid.texture, p, uv, col);
+}
+
+void GeoBuffer::AddCircleFilled(const SolidTexture& solid, ImVec2 center, float radius,
+                                ImU32 col, int segments)
+{
+    // Triangle fan: centre, then the rim.
+    Span& span = SpanFor(solid.texture, (uint32_t)segments + 1);
+    const uint32_t base = span.vtxCount;
+    vtx.push_back({ center.x, center.y, solid.uv.x, solid.uv.y, col });
+    for (int k = 0; k < segments; ++k)
+    {
+        float a = 6.2831853f * (float)k / (float)segments;
+        vtx.push_back({ center.x + std::cos(a) * radius, center.y + std::sin(a) * radius,
+                        solid.uv.x, solid.uv.y, col });
+    }
+    for (int k = 0; k < segments; ++k)
+    {
+        idx.push_back((uint16_t)base);
+        idx.push_back((uint16_t)(base + 1 + k));
+        idx.push_back((uint16_t)(base + 1 + (k + 1) % segments));
+    }
+    span.vtxCount += (uint32_t)segments + 1;
+    span.idxCount += (uint32_t)segments * 3;
+}
+
+void GeoBuffer::AddCircle(const SolidTexture& solid, ImVec2 center, float radius,
+                          ImU32 col, int segments, float thickness)
+{
+    // Ring of quads between an inner and an outer rim, interleaved.
+    const float inner = radius - thickness * 0.5f;
+    const float outer = radius + thickness * 0.5f;
+    Span& span = SpanFor(solid.texture, (uint32_t)segments * 2);
+    const uint32_t base = span.vtxCount;
+    for (int k = 0; k < segments; ++k)
+    {
+        float a = 6.2831853f * (float)k / (float)segments;
+        float c = std::cos(a), s = std::sin(a);
+        vtx.push_back({ center.x + c * inner, center.y + s * inner, solid.uv.x, solid.uv.y, col });
+        vtx.push_back({ center.x + c * outer, center.y + s * outer, solid.uv.x, solid.uv.y, col });
+    }
+    for (int k = 0; k < segments; ++k)
+    {
+        uint16_t i0 = (uint16_t)(base + 2 * k);
+        uint16_t i1 = (uint16_t)(base + 2 * ((k + 1) % segments));
+        const uint16_t quad[6] = { i0, (uint16_t)(i0 + 1), (uint16_t)(i1 + 1),
+                                   i0, (uint16_t)(i1 + 1), i1 };
+        idx.insert(idx.end(), quad, quad + 6);
+    }
+    span.vtxCount += (uint32_t)segments * 2;
+    span.idxCount += (uint32_t)segments * 6;
+}
+
+// ── Submission ────────────────────────────────────────────────────────────────
+
+namespace
+{
+    struct PendingSpan { const GeoBuffer::Span* span; const GeoVertex* vtx; const uint16_t* idx; };
+
+    // 16-bit indices address at most this many vertices per reservation.
+    constexpr size_t kMaxReserveVertices = 65535;
+
+    // One PrimReserve for spans [first, last), rebasing each span's indices.
+    void EmitSpans(ImDrawList* dl, const std::vector<PendingSpan>& spans, size_t first, size_t last,
+                   size_t vtxCount, size_t idxCount)
+    {
+        if (first == last) return;
+        dl->PrimReserve((int)idxCount, (int)vtxCount);
+
+        // PrimReserve may start a new vertex offset, so read the base after.
+        uint32_t base = dl->_VtxCurrentIdx;
+        for (size_t s = first; s < last; ++s)
+        {
+            const GeoBuffer::Span& span = *spans[s].span;
+            // ImDrawVert is trivially copyable; ImVec2's constructors only
+            // make GCC's -Wclass-memaccess think otherwise.
+            memcpy(static_cast<void*>(dl->_VtxWritePtr), spans[s].vtx + span.vtxBegin,
+                   span.vtxCount * sizeof(GeoVertex));
+            dl->_VtxWritePtr += span.vtxCount;
+
+            const uint16_t* src = spans[s].idx + span.idxBegin;
+            for (size_t k = 0; k < span.idxCount; ++k)
+                dl->_IdxWritePtr[k] = (ImDrawIdx)(base + src[k]);
+            dl->_IdxWritePtr += span.idxCount;
+
+            base += span.vtxCount;
+        }
+        dl->_VtxCurrentIdx = base;
+    }
+
+    // Emits spans in order, one texture push per run of equal textures.
+    void Emit(ImDrawList* dl, const std::vector<PendingSpan>& spans)
+    {
+        size_t s = 0;
+        while (s < spans.size())
+        {
+            const ImTextureID texture = spans[s].span->texture;
+            dl->PushTextureID(texture);
+
+            size_t first = s, vtxCount = 0, idxCount = 0;
+            for (; s < spans.size() && spans[s].span->texture == texture; ++s)
+            {
+                if (vtxCount + spans[s].span->vtxCount > kMaxReserveVertices)
+                {
+                    EmitSpans(dl, spans, first, s, vtxCount, idxCount);
+                    first    = s;
+                    vtxCount = idxCount = 0;
+                }
+                vtxCount += spans[s].span->vtxCount;
+                idxCount += spans[s].span->idxCount;
+            }
+            EmitSpans(dl, spans, first, s, vtxCount, idxCount);
+
+            dl->PopTextureID();
+        }
+    }
+
+    std::vector<PendingSpan> g_Pending;   // render thread only
+}
+
+void SubmitInOrder(ImDrawList* dl, const GeoBuffer* const* buffers, size_t count)
+{
+    g_Pending.clear();
+    for (size_t b = 0; b < count; ++b)
+        for (const auto& span : buffers[b]->spans)
+            g_Pending.push_back({ &span, buffers[b]->vtx.data(), buffers[b]->idx.data() });
+    Emit(dl, g_Pending);
+}
+
+void SubmitByTexture(ImDrawList* dl, const GeoBuffer* const* buffers, size_t count)
+{
+    // Rank of each texture by first appearance; a stable sort on it groups
+    // the spans while keeping buffer order within each texture.
+    std::vector<ImTextureID> textures;
+    std::vector<std::pair<size_t, PendingSpan>> ranked;
+    size_t last = 0;
+    for (size_t b = 0; b < count; ++b)
+    {
+        for (const auto& span : buffers[b]->spans)
+        {
+            if (last >= textures.size() || textures[last] != span.texture)
+            {
+                auto it = std::find(textures.begin(), textures.end(), span.texture);
+                if (it == textures.end()) it = textures.insert(it, span.texture);
+                last = (size_t)(it - textures.begin());
+            }
+            ranked.push_back({ last, { &span, buffers[b]->vtx.data(), buffers[b]->idx.data() } });
+        }
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const auto& a, const auto& b){ return a.first < b.first; });
+
+    g_Pending.clear();
+    for (const auto& r : ranked) g_Pending.push_back(r.second);
+    Emit(dl, g_Pending);
+}
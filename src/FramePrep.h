@@ -0,0 +1,92 @@
+#pragma once
+#include <imgui.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Frame preparation buffers
+//
+// Marker and trail geometry is built off the render thread, each worker into
+// its own GeoBuffer, and the render thread only copies the finished buffers
+// into the ImGui draw list (SubmitInOrder / SubmitByTexture).
+//   •  GeoVertex has ImDrawVert's exact layout, so vertices are memcpy'd.
+//   •  Primitives are kept in build order as spans of one texture.  Markers
+//      are submitted in that order (they are drawn far to near) with
+//      neighbouring spans of the same texture merged; trails are grouped by
+//      texture.  Both use bulk PrimReserve calls.
+//   •  Untextured geometry samples the font atlas' white pixel, so it shares
+//      the font texture's spans instead of needing a texture of its own.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct GeoVertex
+{
+    float    x, y;
+    float    u, v;
+    uint32_t col;
+};
+
+static_assert(sizeof(GeoVertex) == sizeof(ImDrawVert),             "GeoVertex must mirror ImDrawVert");
+static_assert(offsetof(GeoVertex, x)   == offsetof(ImDrawVert, pos), "GeoVertex must mirror ImDrawVert");
+static_assert(offsetof(GeoVertex, u)   == offsetof(ImDrawVert, uv),  "GeoVertex must mirror ImDrawVert");
+static_assert(offsetof(GeoVertex, col) == offsetof(ImDrawVert, col), "GeoVertex must mirror ImDrawVert");
+
+// The font atlas texture and the UV of its white pixel, read from ImGui on
+// the render thread before any worker starts.
+struct SolidTexture
+{
+    ImTextureID texture = nullptr;
+    ImVec2      uv;
+};
+
+// Geometry built by one worker, in the order it was added.  Consecutive
+// primitives with the same texture share a span of at most kMaxRunVertices
+// vertices with 16-bit span-relative indices; a primitive never straddles two
+// spans.
+class GeoBuffer
+{
+public:
+    static constexpr uint32_t kMaxRunVertices = 16384;
+
+    // Empties the buffer, keeping its memory for the next frame.
+    void Clear();
+
+    // p / uv are the four corners in order (two triangles 0-1-2, 0-2-3).
+    void AddQuad(ImTextureID texture, const ImVec2 p[4], const ImVec2 uv[4], ImU32 col);
+    void AddSolidQuad(const SolidTexture& solid, const ImVec2 p[4], ImU32 col);
+    void AddCircleFilled(const SolidTexture& solid, ImVec2 center, float radius,
+                         ImU32 col, int segments);
+    void AddCircle(const SolidTexture& solid, ImVec2 center, float radius,
+                   ImU32 col, int segments, float thickness);
+
+    struct Span
+    {
+        ImTextureID texture  = nullptr;
+        uint32_t    vtxBegin = 0, vtxCount = 0;   // into the buffer's vertices
+        uint32_t    idxBegin = 0, idxCount = 0;   // into its indices
+    };
+
+private:
+    friend void SubmitInOrder(ImDrawList*, const GeoBuffer* const*, size_t);
+    friend void SubmitByTexture(ImDrawList*, const GeoBuffer* const*, size_t);
+
+    // Span for texture with room for vtxCount more vertices.
+    Span& SpanFor(ImTextureID texture, uint32_t vtxCount);
+
+    std::vector<GeoVertex> vtx;
+    std::vector<uint16_t>  idx;
+    std::vector<Span>      spans;
+};
+
+// Copy the geometry of count buffers into dl.  Neighbouring spans with the
+// same texture (across buffers too) go out through as few PrimReserve calls
+// as 16-bit indices allow, one draw command per texture change.
+//   •  SubmitInOrder keeps every primitive in buffer order, for geometry that
+//      is drawn back to front (markers).  It batches as well as the geometry's
+//      textures repeat: markers on one atlas page form a single command.
+//   •  SubmitByTexture first groups the spans by texture (in first-seen
+//      order), for geometry whose order across textures doesn't matter
+//      (trails), so it costs one draw command per distinct texture.
+// Render thread only.
+void SubmitInOrder(ImDrawList* dl, const GeoBuffer* const* buffers, size_t count);
+void SubmitByTexture(ImDrawList* dl, const GeoBuffer* const* buffers, size_t count);
@@ -0,0 +1,155 @@
+#include "IconAtlas.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#define STBI_NO_STDIO
+#define STBI_NO_HDR
+#define STBI_NO_LINEAR
+#include <stb_image.h>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#define STBRP_STATIC
+#include <stb_rect_pack.h>
+
+#include <miniz.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+bool IconAtlas::Decode(const void* data, size_t size, Image& out)
+{
+    if (!data || size == 0 || size > 0x7FFFFFFF) return false;
+
+    int w = 0, h = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(static_cast<const stbi_uc*>(data), (int)size,
+                                            &w, &h, &channels, 4);
+    if (!pixels) return false;
+
+    out.width  = w;
+    out.height = h;
+    out.rgba.assign(pixels, pixels + (size_t)w * h * 4);
+    stbi_image_free(pixels);
+    return true;
+}
+
+using namespace IconAtlas;
+
+// Smallest page (power of two) expected to hold area pixels.
+static int PageSizeFor(uint64_t area)
+{
+    // Some slack for what the packer can't fill.
+    double side = std::sqrt((double)area * 1.25);
+    int size = kMinPageSize;
+    while (size < kMaxPageSize && size < side) size *= 2;
+    return size;
+}
+
+// Copies img into page with its top-left pixel at (x, y), then repeats its
+// edge pixels into the kPadding-wide border around it.
+static void Blit(const Image& img, Page& page, int x, int y)
+{
+    const size_t rowBytes = (size_t)img.width * 4;
+    for (int row = -kPadding; row < img.height + kPadding; ++row)
+    {
+        const int      srcRow = std::clamp(row, 0, img.height - 1);
+        const uint8_t* src    = img.rgba.data() + (size_t)srcRow * rowBytes;
+        uint8_t*       dst    = page.rgba.data() + ((size_t)(y + row) * page.size + x) * 4;
+
+        memcpy(dst, src, rowBytes);
+        for (int p = 1; p <= kPadding; ++p)
+        {
+            memcpy(dst - p * 4,                  src,                4);   // left edge
+            memcpy(dst + rowBytes + (p - 1) * 4, src + rowBytes - 4, 4);   // right edge
+        }
+    }
+}
+
+size_t IconAtlas::Pack(const std::vector<Image>& images,
+                       std::vector<Page>& pages, std::vector<Placement>& placements)
+{
+    placements.assign(images.size(), Placement{});
+
+    std::vector<stbrp_rect> pending;
+    uint64_t area = 0;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        const Image& img = images[i];
+        if (img.width <= 0 || img.height <= 0 ||
+            img.width > kMaxIconSize || img.height > kMaxIconSize)
+            continue;
+
+        stbrp_rect r{};
+        r.id = (int)i;
+        r.w  = img.width  + 2 * kPadding;
+        r.h  = img.height + 2 * kPadding;
+        pending.push_back(r);
+        area += (uint64_t)r.w * r.h;
+    }
+
+    size_t packed = 0;
+    std::vector<stbrp_rect> rects;
+    std::vector<stbrp_node> nodes;
+    while (!pending.empty())
+    {
+        // Grow the page until everything left fits or it is as large as
+        // allowed; whatever still doesn't fit goes on the next page.
+        int size = PageSizeFor(area);
+        for (;;)
+        {
+            rects = pending;
+            nodes.resize(size);
+            stbrp_context ctx;
+            stbrp_init_target(&ctx, size, size, nodes.data(), size);
+            bool all = stbrp_pack_rects(&ctx, rects.data(), (int)rects.size()) == 1;
+            if (all || size >= kMaxPageSize) break;
+            size *= 2;
+        }
+
+        const uint32_t pageIndex = (uint32_t)pages.size();
+        pages.emplace_back();
+        Page& page = pages.back();
+        page.size = size;
+        page.rgba.assign((size_t)size * size * 4, 0);
+
+        pending.clear();
+        area = 0;
+        const float inv = 1.f / (float)size;
+        for (const stbrp_rect& r : rects)
+        {
+            if (!r.was_packed)
+            {
+                pending.push_back(r);
+                area += (uint64_t)r.w * r.h;
+                continue;
+            }
+
+            const Image& img = images[r.id];
+            const int    x   = r.x + kPadding;
+            const int    y   = r.y + kPadding;
+            Blit(img, page, x, y);
+
+            Placement& pl = placements[r.id];
+            pl.page = pageIndex;
+            pl.u0   = (float)x * inv;
+            pl.v0   = (float)y * inv;
+            pl.u1   = (float)(x + img.width)  * inv;
+            pl.v1   = (float)(y + img.height) * inv;
+            ++packed;
+        }
+    }
+    return packed;
+}
+
+bool IconAtlas::EncodePng(const Page& page, std::vector<uint8_t>& out)
+{
+    size_t len = 0;
+    void*  png = tdefl_write_image_to_png_file_in_memory_ex(
+        page.rgba.data(), page.size, page.size, 4, &len, MZ_BEST_SPEED, MZ_FALSE);
+    if (!png) return false;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(png);
+    out.assign(bytes, bytes + len);
+    mz_free(png);
+    return true;
+}
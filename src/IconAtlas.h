@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// IconAtlas
+//
+// Packs a pack's marker icons into a few large RGBA pages so markers with
+// different icons share a texture (and an ImGui draw command).
+//   •  Icons are decoded on the loader thread (stb_image, any format it
+//      reads, always expanded to RGBA).
+//   •  Pages are square, a power of two between kMinPageSize and
+//      kMaxPageSize, sized to what is left to pack; rectangles are placed
+//      with stb_rect_pack's skyline packer.
+//   •  Every icon gets a kPadding-pixel border copied from its own edge
+//      pixels, so bilinear sampling at the rectangle's edge never picks up
+//      a neighbour.
+//   •  Finished pages are PNG-encoded (miniz) for the host's texture loader.
+// Plain CPU code — no Nexus or ImGui dependency.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace IconAtlas
+{
+
+constexpr int kMinPageSize = 256;
+constexpr int kMaxPageSize = 2048;
+constexpr int kMaxIconSize = 256;   // larger icons stay standalone textures
+constexpr int kPadding     = 1;
+
+constexpr uint32_t kNoPage = 0xFFFFFFFFu;
+
+struct Image
+{
+    int                  width  = 0;
+    int                  height = 0;
+    std::vector<uint8_t> rgba;        // width * height * 4, rows top to bottom
+};
+
+struct Page
+{
+    int                  size = 0;    // width == height
+    std::vector<uint8_t> rgba;
+};
+
+// Where an image ended up: page index (kNoPage if it wasn't packed) and its
+// UV rectangle within that page, excluding the padding.
+struct Placement
+{
+    uint32_t page = kNoPage;
+    float    u0 = 0.f, v0 = 0.f, u1 = 0.f, v1 = 0.f;
+};
+
+// False if the data isn't an image stb_image can read.
+bool Decode(const void* data, size_t size, Image& out);
+
+// Packs every image no larger than kMaxIconSize on either side into pages
+// (appended to pages); placements[i] describes images[i].  Returns the
+// number of images packed.
+size_t Pack(const std::vector<Image>& images,
+            std::vector<Page>& pages, std::vector<Placement>& placements);
+
+// PNG file image of a page.  False on encoder failure.
+bool EncodePng(const Page& page, std::vector<uint8_t>& out);
+
+} // namespace IconAtlas
@@ -0,0 +1,117 @@
+#include "LoadProfile.h"
+#include "Platform.h"
+
+#include <nlohmann/json.hpp>
+
+#include <ctime>
+#include <fstream>
+
+using json = nlohmann::json;
+using namespace LoadProfile;
+
+namespace
+{
+    std::atomic<uint64_t> g_PeakPrivate{0};
+}
+
+const char* LoadProfile::StageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::ArchiveOpen: return "archiveOpen";
+    case Stage::CacheLoad:   return "cacheLoad";
+    case Stage::Inflate:     return "inflate";
+    case Stage::XmlParse:    return "xmlParse";
+    case Stage::Categories:  return "categories";
+    case Stage::PoiResolve:  return "poiResolve";
+    case Stage::TrailLoad:   return "trailLoad";
+    case Stage::ArcLength:   return "arcLength";
+    case Stage::Index:       return "index";
+    case Stage::Textures:    return "textures";
+    case Stage::CacheSave:   return "cacheSave";
+    default:                 return "?";
+    }
+}
+
+uint64_t LoadProfile::BeginMemoryWatch()
+{
+    uint64_t now = Platform::PrivateBytes();
+    g_PeakPrivate = now;
+    return now;
+}
+
+void LoadProfile::SampleMemory()
+{
+    uint64_t now  = Platform::PrivateBytes();
+    uint64_t peak = g_PeakPrivate.load(std::memory_order_relaxed);
+    while (now > peak && !g_PeakPrivate.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+uint64_t LoadProfile::PeakMemory() { return g_PeakPrivate.load(); }
+
+Stage PackReport::Slowest() const
+{
+    Stage  slowest = Stage::Count;
+    double best    = 0.0;
+    for (size_t s = 0; s < kStageCount; ++s)
+        if (stages[s].ms > best) { best = stages[s].ms; slowest = (Stage)s; }
+    return slowest;
+}
+
+PackReport LoadProfile::Snapshot(const PackProfile& profile, const std::string& name,
+                                 const std::string& result, double wallMs)
+{
+    PackReport r;
+    r.name   = name;
+    r.result = result;
+    r.wallMs = wallMs;
+    for (size_t s = 0; s < kStageCount; ++s)
+    {
+        r.stages[s].ms    = (double)profile.ns[s].load() / 1e6;
+        r.stages[s].bytes = profile.bytes[s].load();
+        r.stages[s].items = profile.items[s].load();
+    }
+    return r;
+}
+
+std::string LoadProfile::Now()
+{
+    std::tm tm = Platform::LocalTime(std::time(nullptr));
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    return buf;
+}
+
+bool LoadProfile::WriteJson(const Report& report, const std::string& path)
+{
+    json j;
+    j["finishedAt"]        = report.finishedAt;
+    j["wallMs"]            = report.wallMs;
+    j["privateBytesStart"] = report.memStart;
+    j["privateBytesPeak"]  = report.memPeak;
+
+    json packs = json::array();
+    for (const auto& pack : report.packs)
+    {
+        json p;
+        p["name"]   = pack.name;
+        p["result"] = pack.result;
+        p["wallMs"] = pack.wallMs;
+
+        json stages = json::object();
+        for (size_t s = 0; s < kStageCount; ++s)
+        {
+            const StageTotals& st = pack.stages[s];
+            if (st.ms == 0.0 && st.bytes == 0 && st.items == 0) continue;
+            stages[StageName((Stage)s)] = { { "ms", st.ms }, { "bytes", st.bytes }, { "items", st.items } };
+        }
+        p["stages"] = std::move(stages);
+        packs.push_back(std::move(p));
+    }
+    j["packs"] = std::move(packs);
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << j.dump(4);
+    return (bool)file;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LoadProfile
+//
+// Where a pack load spends its time.  Every pack gets a PackProfile whose
+// per-stage counters (time, bytes, items) are added to from whichever pool
+// thread does the work; stages that fan out on the pool therefore report
+// time summed over their tasks, which can exceed the pack's wall time.
+// The process' private memory is sampled at stage boundaries for the peak.
+// When the load is done the counters are copied into a Report, written as
+// JSON (load_profile.json) and summarised in the Pathing window.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace LoadProfile
+{
+
+enum class Stage : uint8_t
+{
+    ArchiveOpen,   // mapping the archive, reading its directory, cache key
+    CacheLoad,     // compiled pack cache
+    Inflate,       // XML entries
+    XmlParse,
+    Categories,    // category tree build
+    PoiResolve,    // POIs / trails resolved against the tree, attributes merged
+    TrailLoad,     // .trl inflate + decode
+    ArcLength,
+    Index,         // trail chunks, category / map indices
+    Textures,      // icon decode, atlas packing, texture queueing
+    CacheSave,
+    Count
+};
+constexpr size_t kStageCount = (size_t)Stage::Count;
+
+const char* StageName(Stage stage);
+
+// One pack's counters.  Add may be called from any thread.
+struct PackProfile
+{
+    std::atomic<uint64_t> ns[kStageCount]    {};
+    std::atomic<uint64_t> bytes[kStageCount] {};
+    std::atomic<uint64_t> items[kStageCount] {};
+
+    void Add(Stage stage, uint64_t elapsedNs, uint64_t byteCount = 0, uint64_t itemCount = 0)
+    {
+        const size_t s = (size_t)stage;
+        ns[s].fetch_add(elapsedNs, std::memory_order_relaxed);
+        bytes[s].fetch_add(byteCount, std::memory_order_relaxed);
+        items[s].fetch_add(itemCount, std::memory_order_relaxed);
+    }
+};
+
+inline uint64_t ElapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Adds the time between construction and destruction to a stage, plus
+// whatever bytes / items were counted on it meanwhile.
+class ScopedStage
+{
+public:
+    ScopedStage(PackProfile& profile, Stage stage)
+        : profile(profile), stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~ScopedStage() { profile.Add(stage, ElapsedNs(start), bytes, items); }
+    ScopedStage(const ScopedStage&)            = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+    uint64_t bytes = 0;
+    uint64_t items = 0;
+
+private:
+    PackProfile&                          profile;
+    Stage                                 stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+// ── Memory ────────────────────────────────────────────────────────────────────
+
+// Starts watching for a new peak; returns the current private bytes.
+uint64_t BeginMemoryWatch();
+// Samples private bytes into the peak.  Any thread.
+void     SampleMemory();
+uint64_t PeakMemory();
+
+// ── Report ────────────────────────────────────────────────────────────────────
+
+struct StageTotals
+{
+    double   ms    = 0.0;
+    uint64_t bytes = 0;
+    uint64_t items = 0;
+};
+
+struct PackReport
+{
+    std::string name;
+    std::string result;    // "loaded", "cached", "unchanged" or "failed"
+    double      wallMs = 0.0;
+    StageTotals stages[kStageCount];
+
+    // The stage with the most time, or Stage::Count if none took any.
+    Stage Slowest() const;
+};
+
+struct Report
+{
+    std::string             finishedAt;      // local time, "YYYY-MM-DD HH:MM:SS"
+    double                  wallMs      = 0.0;
+    uint64_t                memStart    = 0;   // private bytes before the load
+    uint64_t                memPeak     = 0;   // highest sample during it
+    std::vector<PackReport> packs;
+};
+
+PackReport Snapshot(const PackProfile& profile, const std::string& name,
+                    const std::string& result, double wallMs);
+
+// Current local time as used in Report::finishedAt.
+std::string Now();
+
+// False if the file can't be written.
+bool WriteJson(const Report& report, const std::string& path);
+
+} // namespace LoadProfile
@@ -0,0 +1,16 @@
+#include "MappedFile.h"
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    return Platform::MapFile(path, mapping);
+}
+
+void MappedFile::Close()
+{
+    Platform::UnmapFile(mapping);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Platform.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// MappedFile
+//
+// Read-only memory mapping of a whole file.  Used for .taco archives and the
+// compiled pack cache so neither has to be copied into a heap buffer first.
+// ─────────────────────────────────────────────────────────────────────────────
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file is missing, empty or can't be mapped.
+    bool Open(const std::string& path);
+    void Close();
+
+    bool           IsOpen() const { return mapping.data != nullptr; }
+    const uint8_t* Data()   const { return mapping.data; }
+    size_t         Size()   const { return mapping.size; }
+
+private:
+    Platform::FileMapping mapping;
+};
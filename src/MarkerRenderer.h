@@ -12,13 +12,20 @@
 //                     →  screen-space ImGui coordinates
 //
 // All drawing happens inside the RT_Render callback (called every frame).
+// This is the Nexus-facing half: it gathers the camera, screen and pack
+// inputs and hands them to SceneRenderer, which culls, builds the geometry on
+// a small worker pool and copies it into ImGui's background draw list.
 // ─────────────────────────────────────────────────────────────────────────────
 namespace MarkerRenderer
 {
 
 // Called from the RT_Render ImGui callback.
-// Reads MumbleLink/MumbleIdent for camera state, queries PackManager for the
-// current map's POIs and trails, projects them and draws with ImGui.
+// Reads MumbleLink/MumbleIdent for camera state and draws the current map's
+// POIs and trails (SceneRenderer::Render), plus the debug overlay.
 void Render();
 
+// Stops the frame-preparation workers.  Call on unload, after the render
+// callback has been deregistered.
+void Shutdown();
+
 } // namespace MarkerRenderer
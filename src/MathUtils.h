@@ -151,6 +151,69 @@ inline float DistSq(const Vec3& a, const Vec3& b)
     return dx*dx + dy*dy + dz*dz;
 }
 
+// ── Axis-aligned bounding box ─────────────────────────────────────────────────
+struct Aabb
+{
+    Vec3 min{ 1e30f,  1e30f,  1e30f};
+    Vec3 max{-1e30f, -1e30f, -1e30f};
+
+    bool Empty() const { return min.x > max.x; }
+
+    void Add(const Vec3& p)
+    {
+        min = { std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z) };
+        max = { std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z) };
+    }
+
+    // Squared distance from p to the nearest point of the box (0 inside).
+    float DistSq(const Vec3& p) const
+    {
+        float dx = std::max({min.x - p.x, 0.f, p.x - max.x});
+        float dy = std::max({min.y - p.y, 0.f, p.y - max.y});
+        float dz = std::max({min.z - p.z, 0.f, p.z - max.z});
+        return dx*dx + dy*dy + dz*dz;
+    }
+};
+
+// ── View frustum ──────────────────────────────────────────────────────────────
+// Culling planes (a·x + b·y + c·z + d >= 0 inside) extracted from a
+// view-projection matrix.  They mirror exactly what WorldToScreen rejects:
+// the four sides at |ndc| <= sideMargin, and w > 0 (in front of the camera).
+// There is no far plane — distance culling is MaxRenderDist's job.
+struct Frustum
+{
+    float planes[5][4] = {};
+
+    static Frustum FromViewProj(const Mat4& vp, float sideMargin = 1.1f)
+    {
+        Frustum f;
+        for (int c = 0; c < 4; ++c)
+        {
+            float x = vp.m[c][0], y = vp.m[c][1], w = vp.m[c][3];
+            f.planes[0][c] = sideMargin * w + x;   // left
+            f.planes[1][c] = sideMargin * w - x;   // right
+            f.planes[2][c] = sideMargin * w + y;   // bottom
+            f.planes[3][c] = sideMargin * w - y;   // top
+            f.planes[4][c] = w;                    // behind the camera
+        }
+        return f;
+    }
+
+    // False only if the box is entirely outside one plane (conservative).
+    bool Intersects(const Aabb& b) const
+    {
+        for (const auto& p : planes)
+        {
+            // Corner of the box furthest along the plane normal.
+            float x = p[0] >= 0.f ? b.max.x : b.min.x;
+            float y = p[1] >= 0.f ? b.max.y : b.min.y;
+            float z = p[2] >= 0.f ? b.max.z : b.min.z;
+            if (p[0]*x + p[1]*y + p[2]*z + p[3] < 0.f) return false;
+        }
+        return true;
+    }
+};
+
 // ── Linear remap ─────────────────────────────────────────────────────────────
 inline float Remap(float v, float lo, float hi, float outLo, float outHi)
 {
@@ -0,0 +1,144 @@
+#include "PackArchive.h"
+#include "TacoParser.h"
+
+#include <miniz.h>
+
+#include <cstring>
+
+// ZIP local file header: fixed 30 bytes followed by the file name and the
+// extra field.  The central directory's lengths for those two fields are not
+// guaranteed to match the local header, so the local copy is always read.
+static constexpr uint32_t kLocalHeaderSig  = 0x04034b50;
+static constexpr size_t   kLocalHeaderSize = 30;
+
+static uint16_t ReadU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t ReadU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+PackArchive::~PackArchive()
+{
+    Close();
+}
+
+bool PackArchive::Open(const std::string& archivePath)
+{
+    Close();
+    path = archivePath;
+
+    if (!file.Open(archivePath) || file.Size() < kLocalHeaderSize)
+    {
+        Close();
+        return false;
+    }
+    const uint8_t* base = file.Data();
+    size_t         size = file.Size();
+
+    // Let miniz walk the central directory, then keep only what Read() needs.
+    mz_zip_archive zip{};
+    if (!mz_zip_reader_init_mem(&zip, base, size, 0)) { Close(); return false; }
+
+    mz_uint fileCount = mz_zip_reader_get_num_files(&zip);
+    entries.reserve(fileCount);
+    index.reserve(fileCount);
+
+    for (mz_uint i = 0; i < fileCount; ++i)
+    {
+        mz_zip_archive_file_stat stat{};
+        if (!mz_zip_reader_file_stat(&zip, i, &stat)) continue;
+        if (stat.m_is_directory || stat.m_is_encrypted) continue;
+
+        uint64_t hdr = stat.m_local_header_ofs;
+        if (hdr + kLocalHeaderSize > size) continue;
+        if (ReadU32(base + hdr) != kLocalHeaderSig) continue;
+
+        uint64_t dataOfs = hdr + kLocalHeaderSize
+                         + ReadU16(base + hdr + 26)     // file name length
+                         + ReadU16(base + hdr + 28);    // extra field length
+        if (dataOfs + stat.m_comp_size > size) continue;
+
+        Entry e;
+        e.name       = TacoParser::NormalisePath(stat.m_filename);
+        e.dataOffset = dataOfs;
+        e.compSize   = stat.m_comp_size;
+        e.size       = stat.m_uncomp_size;
+        e.crc32      = stat.m_crc32;
+        e.method     = stat.m_method;
+
+        // Duplicate names (differing only in case / slashes): first one wins,
+        // matching what the old extract-to-disk path ended up with.
+        if (index.emplace(e.name, entries.size()).second)
+            entries.push_back(std::move(e));
+    }
+
+    mz_zip_reader_end(&zip);
+    return true;
+}
+
+void PackArchive::Close()
+{
+    file.Close();
+    entries.clear();
+    index.clear();
+}
+
+uint64_t PackArchive::ContentHash() const
+{
+    // FNV-1a, 64-bit
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* p, size_t n)
+    {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 0x100000001b3ull; }
+    };
+    for (const auto& e : entries)
+    {
+        mix(e.name.data(), e.name.size() + 1);
+        mix(&e.size,  sizeof(e.size));
+        mix(&e.crc32, sizeof(e.crc32));
+    }
+    return h;
+}
+
+const PackArchive::Entry* PackArchive::Find(const std::string& normPath) const
+{
+    auto it = index.find(normPath);
+    return it != index.end() ? &entries[it->second] : nullptr;
+}
+
+bool PackArchive::Read(const Entry& entry, std::vector<uint8_t>& out) const
+{
+    if (!file.IsOpen()) return false;
+
+    out.resize((size_t)entry.size);
+    if (entry.size == 0) return true;
+
+    const uint8_t* src = file.Data() + entry.dataOffset;
+
+    if (entry.method == 0)
+    {
+        if (entry.compSize != entry.size) return false;
+        memcpy(out.data(), src, (size_t)entry.size);
+    }
+    else if (entry.method == MZ_DEFLATED)
+    {
+        // Raw deflate stream (no zlib header) straight from the mapped file.
+        size_t n = tinfl_decompress_mem_to_mem(out.data(), out.size(),
+                                               src, (size_t)entry.compSize, 0);
+        if (n == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED || n != out.size())
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    return mz_crc32(MZ_CRC32_INIT, out.data(), out.size()) == entry.crc32;
+}
+
+bool PackArchive::Read(const std::string& normPath, std::vector<uint8_t>& out) const
+{
+    const Entry* e = Find(normPath);
+    return e && Read(*e, out);
+}
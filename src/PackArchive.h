@@ -0,0 +1,68 @@
+#pragma once
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// PackArchive
+//
+// Read-only, in-memory view of a .taco (ZIP) archive.
+//   •  The archive file is memory-mapped; only the central directory is
+//      parsed on Open().
+//   •  Entries are inflated on demand into caller-owned heap buffers —
+//      nothing is ever written to disk.
+//   •  Read() is const and uses no shared miniz state, so several threads may
+//      inflate entries from the same archive concurrently.
+//
+// Entry names are normalised with TacoParser::NormalisePath (lower-case,
+// forward slashes) so they match the paths referenced from pack XML.
+// ─────────────────────────────────────────────────────────────────────────────
+class PackArchive
+{
+public:
+    struct Entry
+    {
+        std::string name;          // normalised pack-relative path
+        uint64_t    dataOffset = 0;  // offset of the compressed bytes in the file
+        uint64_t    compSize   = 0;
+        uint64_t    size       = 0;  // uncompressed size
+        uint32_t    crc32      = 0;
+        uint16_t    method     = 0;  // 0 = stored, 8 = deflate
+    };
+
+    PackArchive() = default;
+    ~PackArchive();
+    PackArchive(const PackArchive&)            = delete;
+    PackArchive& operator=(const PackArchive&) = delete;
+
+    // Maps the file and reads its central directory.  Returns false if the
+    // file can't be opened or isn't a readable ZIP archive.
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file.IsOpen(); }
+
+    const std::string&        Path()    const { return path; }
+    const std::vector<Entry>& Entries() const { return entries; }
+
+    // Hash over every entry's name, size and CRC32 from the central
+    // directory — changes whenever the content of any file changes, without
+    // reading the file data itself.
+    uint64_t ContentHash() const;
+
+    // Lookup by normalised path; nullptr if the archive has no such file.
+    const Entry* Find(const std::string& normPath) const;
+
+    // Inflate one entry into out (replacing its contents).  Returns false on
+    // an unsupported compression method, corrupt data or a CRC mismatch.
+    bool Read(const Entry& entry, std::vector<uint8_t>& out) const;
+    bool Read(const std::string& normPath, std::vector<uint8_t>& out) const;
+
+private:
+    std::string path;
+    MappedFile  file;
+
+    std::vector<Entry>                      entries;
+    std::unordered_map<std::string, size_t> index;   // normalised name → entries[i]
+};
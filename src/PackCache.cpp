@@ -0,0 +1,518 @@
+#include "PackCache.h"
+#include "PackArchive.h"
+#include "MappedFile.h"
+#include "Platform.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr uint32_t kMagic   = 0x43485450;   // "PTHC"
+constexpr uint32_t kVersion = 4;
+constexpr int      kMaxCategoryDepth = 256;
+
+struct Section { uint64_t offset; uint64_t count; };
+struct StrRef  { uint32_t offset; uint32_t length; };
+
+struct CachedAttribs
+{
+    StrRef   iconFile;
+    StrRef   texture;
+    float    iconSize;
+    float    alpha;
+    uint32_t color;
+    float    heightOffset;
+    float    fadeNear;
+    float    fadeFar;
+    float    minSize;
+    float    maxSize;
+    int32_t  behavior;
+    float    triggerRange;
+    int32_t  resetLength;
+    uint32_t trailColor;
+    float    trailScale;
+    float    animSpeedMult;
+    uint8_t  canFade;
+    uint8_t  autoTrigger;
+    uint8_t  pad[6];
+};
+
+struct CachedCategory
+{
+    StrRef        name;
+    StrRef        displayName;
+    CachedAttribs attribs;
+    uint32_t      childCount;
+    uint32_t      pad;
+};
+
+struct CachedSource
+{
+    StrRef        file;
+    uint32_t      crc32;
+    uint32_t      pad;
+    uint64_t      categoryHash;
+};
+
+struct CachedPoi
+{
+    uint32_t      mapId;
+    uint32_t      source;
+    float         x, y, z;
+    uint32_t      attrib;          // index into attribs
+    StrRef        type;
+    StrRef        guid;
+};
+
+struct CachedTrail
+{
+    uint32_t      mapId;
+    uint32_t      pointCount;
+    uint64_t      firstPoint;      // index into points / arcLengths
+    uint32_t      source;
+    uint32_t      attrib;          // index into attribs
+    StrRef        type;
+    StrRef        trailDataFile;
+    uint64_t      firstChunk;      // index into chunks
+    uint64_t      firstLod;        // index into lodIndices
+    uint32_t      chunkCount;
+    uint32_t      lodCount;
+    TrailPoint    boundsMin;
+    TrailPoint    boundsMax;
+};
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t archiveSize;
+    uint64_t archiveMtime;
+    uint64_t contentHash;
+    uint32_t rootCategories;
+    uint32_t pad;
+    Section  strings;
+    Section  sources;
+    Section  categories;
+    Section  attribs;
+    Section  pois;
+    Section  trails;
+    Section  points;
+    Section  arcLengths;
+    Section  chunks;
+    Section  lodIndices;
+};
+
+static_assert(std::is_trivially_copyable<Header>::value,         "cache records must be POD");
+static_assert(std::is_trivially_copyable<CachedSource>::value,   "cache records must be POD");
+static_assert(std::is_trivially_copyable<CachedCategory>::value, "cache records must be POD");
+static_assert(std::is_trivially_copyable<CachedAttribs>::value,  "cache records must be POD");
+static_assert(std::is_trivially_copyable<CachedPoi>::value,      "cache records must be POD");
+static_assert(std::is_trivially_copyable<CachedTrail>::value,    "cache records must be POD");
+static_assert(std::is_trivially_copyable<TrailPoint>::value,     "cache records must be POD");
+static_assert(std::is_trivially_copyable<TrailChunk>::value,     "cache records must be POD");
+
+// ── Writing ───────────────────────────────────────────────────────────────────
+
+class StringTable
+{
+public:
+    StrRef Add(const std::string& s)
+    {
+        if (s.empty()) return StrRef{0, 0};
+        auto it = refs.find(s);
+        if (it != refs.end()) return it->second;
+        StrRef r{ (uint32_t)blob.size(), (uint32_t)s.size() };
+        blob.insert(blob.end(), s.begin(), s.end());
+        refs.emplace(s, r);
+        return r;
+    }
+    const std::vector<char>& Blob() const { return blob; }
+
+private:
+    std::vector<char>                       blob;
+    std::unordered_map<std::string, StrRef> refs;
+};
+
+static CachedAttribs PackAttribs(const MarkerAttribs& a, StringTable& str)
+{
+    CachedAttribs c{};
+    c.iconFile      = str.Add(a.iconFile);
+    c.texture       = str.Add(a.texture);
+    c.iconSize      = a.iconSize;
+    c.alpha         = a.alpha;
+    c.color         = a.color;
+    c.heightOffset  = a.heightOffset;
+    c.fadeNear      = a.fadeNear;
+    c.fadeFar       = a.fadeFar;
+    c.minSize       = a.minSize;
+    c.maxSize       = a.maxSize;
+    c.behavior      = a.behavior;
+    c.triggerRange  = a.triggerRange;
+    c.resetLength   = a.resetLength;
+    c.trailColor    = a.trailColor;
+    c.trailScale    = a.trailScale;
+    c.animSpeedMult = a.animSpeedMult;
+    c.canFade       = a.canFade     ? 1 : 0;
+    c.autoTrigger   = a.autoTrigger ? 1 : 0;
+    return c;
+}
+
+static void FlattenCategories(const std::vector<MarkerCategory>& cats, StringTable& str,
+                              std::vector<CachedCategory>& out)
+{
+    for (const auto& cat : cats)
+    {
+        CachedCategory c{};
+        c.name        = str.Add(cat.name);
+        c.displayName = str.Add(cat.displayName);
+        c.attribs     = PackAttribs(cat.attribs, str);
+        c.childCount  = (uint32_t)cat.children.size();
+        out.push_back(c);
+        FlattenCategories(cat.children, str, out);
+    }
+}
+
+template <typename T>
+static Section AppendSection(std::vector<uint8_t>& buf, const T* data, size_t count)
+{
+    buf.resize((buf.size() + 7) & ~size_t(7), 0);
+    Section s{ buf.size(), count };
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    buf.insert(buf.end(), p, p + count * sizeof(T));
+    return s;
+}
+
+// ── Reading ───────────────────────────────────────────────────────────────────
+
+class Reader
+{
+public:
+    Reader(const uint8_t* base, size_t size) : base(base), size(size) {}
+
+    template <typename T>
+    const T* Array(const Section& s) const
+    {
+        if (s.count == 0) return reinterpret_cast<const T*>(base);
+        if (s.offset % alignof(T) != 0 || s.offset > size) return nullptr;
+        if (s.count > (size - s.offset) / sizeof(T)) return nullptr;
+        return reinterpret_cast<const T*>(base + s.offset);
+    }
+
+    void SetStrings(const char* blob, uint64_t length) { strings = blob; stringsLen = length; }
+
+    bool Str(const StrRef& r, std::string& out) const
+    {
+        if ((uint64_t)r.offset + r.length > stringsLen) return false;
+        out.assign(strings + r.offset, r.length);
+        return true;
+    }
+
+    bool Attribs(const CachedAttribs& c, MarkerAttribs& a) const
+    {
+        if (!Str(c.iconFile, a.iconFile) || !Str(c.texture, a.texture)) return false;
+        a.iconSize      = c.iconSize;
+        a.alpha         = c.alpha;
+        a.color         = c.color;
+        a.heightOffset  = c.heightOffset;
+        a.fadeNear      = c.fadeNear;
+        a.fadeFar       = c.fadeFar;
+        a.minSize       = c.minSize;
+        a.maxSize       = c.maxSize;
+        a.behavior      = c.behavior;
+        a.triggerRange  = c.triggerRange;
+        a.resetLength   = c.resetLength;
+        a.trailColor    = c.trailColor;
+        a.trailScale    = c.trailScale;
+        a.animSpeedMult = c.animSpeedMult;
+        a.canFade       = c.canFade != 0;
+        a.autoTrigger   = c.autoTrigger != 0;
+        return true;
+    }
+
+private:
+    const uint8_t* base;
+    size_t         size;
+    const char*    strings    = nullptr;
+    uint64_t       stringsLen = 0;
+};
+
+static bool ReadCategories(const Reader& rd, const CachedCategory* recs, uint64_t count,
+                           uint64_t& next, uint32_t siblings,
+                           std::vector<MarkerCategory>& out, int depth)
+{
+    if (depth > kMaxCategoryDepth) return false;
+    // Every sibling needs a record of its own; a count the file can't back
+    // is corruption, not something to reserve memory for.
+    if (siblings > count - next) return false;
+    out.reserve(siblings);
+    for (uint32_t i = 0; i < siblings; ++i)
+    {
+        if (next >= count) return false;
+        const CachedCategory& r = recs[next++];
+
+        MarkerCategory cat;
+        if (!rd.Str(r.name, cat.name) || !rd.Str(r.displayName, cat.displayName) ||
+            !rd.Attribs(r.attribs, cat.attribs))
+            return false;
+        if (!ReadCategories(rd, recs, count, next, r.childCount, cat.children, depth + 1))
+            return false;
+        out.push_back(std::move(cat));
+    }
+    return true;
+}
+
+// Rewrite only the header's archive time, for a touched archive whose content
+// still matches; everything after it is already correct.
+static bool Restamp(const std::string& cachePath, uint64_t archiveMtime)
+{
+    std::fstream f(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!f.is_open()) return false;
+    f.seekp(offsetof(Header, archiveMtime));
+    f.write(reinterpret_cast<const char*>(&archiveMtime), sizeof(archiveMtime));
+    return (bool)f;
+}
+
+} // namespace
+
+bool PackCache::ComputeKey(const PackArchive& archive, Key& out)
+{
+    if (!Platform::FileStamp(archive.Path(), out.archiveSize, out.archiveMtime))
+        return false;
+
+    out.contentHash = archive.ContentHash();
+    return true;
+}
+
+std::string PackCache::CachePathFor(const std::string& cacheDir, const std::string& tacoFile)
+{
+    std::string filename = tacoFile;
+    auto sep = filename.find_last_of("\\/");
+    if (sep != std::string::npos) filename = filename.substr(sep + 1);
+    auto dot = filename.rfind('.');
+    if (dot != std::string::npos) filename = filename.substr(0, dot);
+
+    for (char& c : filename)
+        if (c == ' ' || c == ':' || c == '*' || c == '?' || c == '"' ||
+            c == '<' || c == '>' || c == '|') c = '_';
+
+    return cacheDir + "\\" + filename + ".pcache";
+}
+
+bool PackCache::Load(const std::string& cachePath, const Key& key, TacoPack& out)
+{
+    MappedFile file;
+    if (!file.Open(cachePath) || file.Size() < sizeof(Header)) return false;
+
+    Header h;
+    memcpy(&h, file.Data(), sizeof(Header));
+    if (h.magic != kMagic || h.version != kVersion) return false;
+    if (!Key{h.archiveSize, h.archiveMtime, h.contentHash}.SameContent(key)) return false;
+
+    Reader rd(file.Data(), file.Size());
+    const char*           strings = rd.Array<char>(h.strings);
+    const CachedSource*   sources = rd.Array<CachedSource>(h.sources);
+    const CachedCategory* cats    = rd.Array<CachedCategory>(h.categories);
+    const CachedAttribs*  attribs = rd.Array<CachedAttribs>(h.attribs);
+    const CachedPoi*      pois    = rd.Array<CachedPoi>(h.pois);
+    const CachedTrail*    trails  = rd.Array<CachedTrail>(h.trails);
+    const TrailPoint*     points  = rd.Array<TrailPoint>(h.points);
+    const float*          arcs    = rd.Array<float>(h.arcLengths);
+    const TrailChunk*     chunks  = rd.Array<TrailChunk>(h.chunks);
+    const uint32_t*       lods    = rd.Array<uint32_t>(h.lodIndices);
+    if (!strings || !sources || !cats || !attribs || !pois || !trails || !points || !arcs ||
+        !chunks || !lods) return false;
+    if (h.arcLengths.count != h.points.count) return false;
+    rd.SetStrings(strings, h.strings.count);
+
+    std::vector<PackSource> outSources(h.sources.count);
+    for (uint64_t i = 0; i < h.sources.count; ++i)
+    {
+        if (!rd.Str(sources[i].file, outSources[i].file)) return false;
+        outSources[i].crc32        = sources[i].crc32;
+        outSources[i].categoryHash = sources[i].categoryHash;
+    }
+
+    std::vector<MarkerCategory> categories;
+    uint64_t next = 0;
+    if (!ReadCategories(rd, cats, h.categories.count, next, h.rootCategories, categories, 0))
+        return false;
+
+    std::vector<MarkerAttribs> outAttribs(h.attribs.count);
+    for (uint64_t i = 0; i < h.attribs.count; ++i)
+        if (!rd.Attribs(attribs[i], outAttribs[i])) return false;
+
+    std::vector<Poi> outPois(h.pois.count);
+    for (uint64_t i = 0; i < h.pois.count; ++i)
+    {
+        const CachedPoi& r = pois[i];
+        Poi& poi = outPois[i];
+        poi.mapId  = r.mapId;
+        poi.source = r.source;
+        poi.attrib = r.attrib;
+        if (r.source >= h.sources.count || r.attrib >= h.attribs.count) return false;
+        poi.x = r.x; poi.y = r.y; poi.z = r.z;
+        if (!rd.Str(r.type, poi.type) || !rd.Str(r.guid, poi.guid))
+            return false;
+    }
+
+    std::vector<Trail> outTrails(h.trails.count);
+    for (uint64_t i = 0; i < h.trails.count; ++i)
+    {
+        const CachedTrail& r = trails[i];
+        Trail& trail = outTrails[i];
+        trail.mapId  = r.mapId;
+        trail.source = r.source;
+        trail.attrib = r.attrib;
+        if (r.source >= h.sources.count || r.attrib >= h.attribs.count) return false;
+        if (!rd.Str(r.type, trail.type) || !rd.Str(r.trailDataFile, trail.trailDataFile))
+            return false;
+        if (r.firstPoint > h.points.count || r.pointCount > h.points.count - r.firstPoint)
+            return false;
+        trail.points.assign(points + r.firstPoint, points + r.firstPoint + r.pointCount);
+        trail.arcLengths.assign(arcs + r.firstPoint, arcs + r.firstPoint + r.pointCount);
+
+        // Chunks and LODs index straight into the points when drawn, so every
+        // range is checked against this trail.
+        if (r.firstChunk > h.chunks.count || r.chunkCount > h.chunks.count - r.firstChunk ||
+            r.firstLod > h.lodIndices.count || r.lodCount > h.lodIndices.count - r.firstLod)
+            return false;
+        trail.chunks.assign(chunks + r.firstChunk, chunks + r.firstChunk + r.chunkCount);
+        trail.lodIndices.assign(lods + r.firstLod, lods + r.firstLod + r.lodCount);
+        for (const TrailChunk& c : trail.chunks)
+        {
+            if ((uint64_t)c.first + c.count > r.pointCount) return false;
+            for (int l = 0; l < kTrailLodLevels - 1; ++l)
+                if ((uint64_t)c.lodFirst[l] + c.lodCount[l] > r.lodCount) return false;
+        }
+        for (uint32_t index : trail.lodIndices)
+            if (index >= r.pointCount) return false;
+        trail.boundsMin = r.boundsMin;
+        trail.boundsMax = r.boundsMax;
+    }
+
+    out.sources    = std::move(outSources);
+    out.categories = std::move(categories);
+    out.attribs    = std::move(outAttribs);
+    out.pois       = std::move(outPois);
+    out.trails     = std::move(outTrails);
+
+    // Touched archive: store its new time so the header matches again.  A failed
+    // write only means the content comparison decides again next time.
+    if (h.archiveMtime != key.archiveMtime)
+    {
+        file.Close();
+        Restamp(cachePath, key.archiveMtime);
+    }
+    return true;
+}
+
+bool PackCache::Save(const std::string& cachePath, const Key& key, const TacoPack& pack)
+{
+    StringTable str;
+
+    std::vector<CachedSource> sources;
+    sources.reserve(pack.sources.size());
+    for (const auto& src : pack.sources)
+    {
+        CachedSource r{};
+        r.file         = str.Add(src.file);
+        r.crc32        = src.crc32;
+        r.categoryHash = src.categoryHash;
+        sources.push_back(r);
+    }
+
+    std::vector<CachedCategory> cats;
+    FlattenCategories(pack.categories, str, cats);
+
+    std::vector<CachedAttribs> attribs;
+    attribs.reserve(pack.attribs.size());
+    for (const auto& a : pack.attribs)
+        attribs.push_back(PackAttribs(a, str));
+
+    std::vector<CachedPoi> pois;
+    pois.reserve(pack.pois.size());
+    for (const auto& poi : pack.pois)
+    {
+        CachedPoi r{};
+        r.mapId   = poi.mapId;
+        r.source  = poi.source;
+        r.x = poi.x; r.y = poi.y; r.z = poi.z;
+        r.type    = str.Add(poi.type);
+        r.guid    = str.Add(poi.guid);
+        r.attrib  = poi.attrib;
+        pois.push_back(r);
+    }
+
+    std::vector<CachedTrail> trails;
+    std::vector<TrailPoint>  points;
+    std::vector<float>       arcs;
+    std::vector<TrailChunk>  chunks;
+    std::vector<uint32_t>    lods;
+    trails.reserve(pack.trails.size());
+    for (const auto& trail : pack.trails)
+    {
+        if (trail.arcLengths.size() != trail.points.size()) return false;
+
+        CachedTrail r{};
+        r.mapId         = trail.mapId;
+        r.pointCount    = (uint32_t)trail.points.size();
+        r.firstPoint    = points.size();
+        r.source        = trail.source;
+        r.type          = str.Add(trail.type);
+        r.trailDataFile = str.Add(trail.trailDataFile);
+        r.attrib        = trail.attrib;
+        r.firstChunk    = chunks.size();
+        r.chunkCount    = (uint32_t)trail.chunks.size();
+        r.firstLod      = lods.size();
+        r.lodCount      = (uint32_t)trail.lodIndices.size();
+        r.boundsMin     = trail.boundsMin;
+        r.boundsMax     = trail.boundsMax;
+        trails.push_back(r);
+
+        points.insert(points.end(), trail.points.begin(),     trail.points.end());
+        arcs.insert(  arcs.end(),   trail.arcLengths.begin(), trail.arcLengths.end());
+        chunks.insert(chunks.end(), trail.chunks.begin(),     trail.chunks.end());
+        lods.insert(  lods.end(),   trail.lodIndices.begin(), trail.lodIndices.end());
+    }
+
+    Header h{};
+    h.magic          = kMagic;
+    h.version        = kVersion;
+    h.archiveSize    = key.archiveSize;
+    h.archiveMtime   = key.archiveMtime;
+    h.contentHash    = key.contentHash;
+    h.rootCategories = (uint32_t)pack.categories.size();
+
+    std::vector<uint8_t> buf(sizeof(Header), 0);
+    h.strings    = AppendSection(buf, str.Blob().data(), str.Blob().size());
+    h.sources    = AppendSection(buf, sources.data(), sources.size());
+    h.categories = AppendSection(buf, cats.data(),   cats.size());
+    h.attribs    = AppendSection(buf, attribs.data(), attribs.size());
+    h.pois       = AppendSection(buf, pois.data(),   pois.size());
+    h.trails     = AppendSection(buf, trails.data(), trails.size());
+    h.points     = AppendSection(buf, points.data(), points.size());
+    h.arcLengths = AppendSection(buf, arcs.data(),   arcs.size());
+    h.chunks     = AppendSection(buf, chunks.data(), chunks.size());
+    h.lodIndices = AppendSection(buf, lods.data(),   lods.size());
+    memcpy(buf.data(), &h, sizeof(Header));
+
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream f(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return false;
+        f.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+        if (!f) { f.close(); std::remove(tmpPath.c_str()); return false; }
+    }
+    if (!Platform::ReplaceFile(tmpPath, cachePath))
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "TacoPack.h"
+#include <string>
+#include <cstdint>
+
+class PackArchive;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// PackCache
+//
+// Compiled binary form of a parsed TacoPack, one file per pack under
+// <addondir>/cache/.  Loading a pack from its cache skips XML parsing, .trl
+// inflation and trail chunk / LOD building entirely.
+//
+// A cache file is only used when it describes the same archive content:
+//   •  archive size
+//   •  content hash over the ZIP central directory (entry names, sizes and
+//      CRC32s), read while opening the archive anyway, so it costs nothing
+// The last-write time is stored too but only decides whether the header is
+// current: a touched-but-identical archive still hits (and Load rewrites the
+// stored time to match), an edited one with a preserved timestamp still misses.
+//
+// File layout (little-endian, every section 8-byte aligned):
+//   Header      magic, version, key, section table
+//   strings     char blob referenced by (offset, length) pairs
+//   sources     the pack's XML files with their CRC32 / category fingerprint
+//   categories  flattened category tree, depth-first pre-order
+//   attribs     the pack's deduplicated MarkerAttribs table
+//   pois        fixed-size records referencing attribs by index
+//   trails      fixed-size records indexing into points / arcLengths
+//   points      TrailPoint[]
+//   arcLengths  float[]
+//   chunks      TrailChunk[], per trail, as TacoParser::BuildTrailChunks left them
+//   lodIndices  uint32_t[], the chunks' simplified levels
+// The sections are plain arrays of trivially-copyable records so the file is
+// read directly from a memory mapping.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace PackCache
+{
+
+struct Key
+{
+    uint64_t archiveSize  = 0;
+    uint64_t archiveMtime = 0;
+    uint64_t contentHash  = 0;
+
+    bool operator==(const Key& o) const
+    {
+        return archiveSize == o.archiveSize && archiveMtime == o.archiveMtime &&
+               contentHash == o.contentHash;
+    }
+    bool operator!=(const Key& o) const { return !(*this == o); }
+
+    // Same archive bytes as far as the pack is concerned, whatever the mtime.
+    bool SameContent(const Key& o) const
+    {
+        return archiveSize == o.archiveSize && contentHash == o.contentHash;
+    }
+};
+
+// Build the key for an archive that is already open.
+bool ComputeKey(const PackArchive& archive, Key& out);
+
+// Path of the cache file for a given .taco file.
+std::string CachePathFor(const std::string& cacheDir, const std::string& tacoFile);
+
+// Fills out (sources, categories, attribs, POIs, trails with their chunks) from the
+// cache file if it exists, is the current version and has key's content.  If only
+// the archive time differs the file's stored time is rewritten to key's.
+// out.name / filePath are untouched.
+bool Load(const std::string& cachePath, const Key& key, TacoPack& out);
+
+// Writes the pack atomically (temp file + rename).  Trails are stored with the
+// chunks they have, so build those first.  Returns false on I/O error.
+bool Save(const std::string& cachePath, const Key& key, const TacoPack& pack);
+
+} // namespace PackCache
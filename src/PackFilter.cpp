@@ -0,0 +1,40 @@
+#include "PackManager.h"
+
+// Per-map filtering over pack data.  Kept apart from PackManager.cpp, which
+// owns loading and the Nexus texture side, so it builds on its own.
+
+void PackManager::FilterPoisForMap(const std::vector<TacoPack>& packs, uint32_t mapId,
+                                   std::vector<PoiView>& out)
+{
+    out.clear();
+    for (const auto& pack : packs)
+    {
+        if (!pack.enabled) continue;
+        const MapRange* range = pack.FindMap(mapId);
+        if (!range) continue;
+        for (uint32_t i = range->poiBegin; i < range->poiEnd; ++i)
+        {
+            const Poi& poi = pack.pois[i];
+            if (pack.IsCategoryEnabled(poi.category))
+                out.push_back({&poi, &pack.AttribsOf(poi), &pack.icons[poi.attrib]});
+        }
+    }
+}
+
+void PackManager::FilterTrailsForMap(const std::vector<TacoPack>& packs, uint32_t mapId,
+                                     std::vector<TrailView>& out)
+{
+    out.clear();
+    for (const auto& pack : packs)
+    {
+        if (!pack.enabled) continue;
+        const MapRange* range = pack.FindMap(mapId);
+        if (!range) continue;
+        for (uint32_t i = range->trailBegin; i < range->trailEnd; ++i)
+        {
+            const Trail& trail = pack.trails[i];
+            if (pack.IsCategoryEnabled(trail.category))
+                out.push_back({&trail, &pack.AttribsOf(trail)});
+        }
+    }
+}
@@ -0,0 +1,362 @@
+#include "PackLoader.h"
+#include "PackArchive.h"
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace PackLoader;
+
+// Outcome of loading one trail's .trl binary.  Trails load as independent
+// tasks and are compacted afterwards so the result keeps XML order.
+enum class TrailResult : uint8_t { Loaded, FileNotFound, BinaryFailed, NoMapId, NoPoints };
+
+static TrailResult LoadTrail(const PackArchive& archive, Trail& trail,
+                             LoadProfile::PackProfile& prof)
+{
+    {
+        LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::TrailLoad);
+        const PackArchive::Entry* entry =
+            archive.Find(TacoParser::NormalisePath(trail.trailDataFile));
+        if (!entry) return TrailResult::FileNotFound;
+
+        std::vector<uint8_t> buf;
+        bool read = archive.Read(*entry, buf);
+        stage.bytes = buf.size();
+        stage.items = 1;
+        if (!read || !TacoParser::LoadTrailBinaryMemory(buf.data(), buf.size(), trail))
+            return TrailResult::BinaryFailed;
+    }
+
+    if (trail.mapId == 0)     return TrailResult::NoMapId;
+    if (trail.points.empty()) return TrailResult::NoPoints;
+
+    {
+        LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::ArcLength);
+        stage.items = trail.points.size();
+        TacoParser::ComputeArcLengths(trail);
+    }
+
+    LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::Index);
+    TacoParser::BuildTrailChunks(trail);
+    return TrailResult::Loaded;
+}
+
+bool PackLoader::HasExtension(const std::string& normPath, const char* ext)
+{
+    size_t n = strlen(ext);
+    return normPath.size() >= n && normPath.compare(normPath.size() - n, n, ext) == 0;
+}
+
+PrevPack PackLoader::SnapshotPrev(const TacoPack& pack)
+{
+    PrevPack prev;
+    prev.archiveSize   = pack.archiveSize;
+    prev.archiveMtime  = pack.archiveMtime;
+    prev.contentHash   = pack.contentHash;
+    prev.sources       = pack.sources;
+    prev.trailFileCrcs = pack.trailFileCrcs;
+    prev.categories    = pack.categories;
+    prev.pack          = &pack;
+    return prev;
+}
+
+// For each XML entry, the index of the identical source in prev, or -1 if the
+// file has to be parsed again.  A source is carried over only when its own
+// CRC is unchanged and so is every .trl its trails read.  If any .trl was
+// added or removed nothing is carried over: trails that failed to load last
+// time aren't recorded, so there's no telling which file referenced it.
+static std::vector<int> MatchUnchangedSources(const PackArchive& archive, const PrevPack& prev,
+                                              const std::vector<const PackArchive::Entry*>& xmlEntries)
+{
+    std::vector<int> reuse(xmlEntries.size(), -1);
+
+    size_t trlCount = 0;
+    for (const auto& entry : archive.Entries())
+    {
+        if (!HasExtension(entry.name, ".trl")) continue;
+        if (prev.trailFileCrcs.find(entry.name) == prev.trailFileCrcs.end()) return reuse;
+        ++trlCount;
+    }
+    if (trlCount != prev.trailFileCrcs.size()) return reuse;
+
+    std::vector<char> stale(prev.sources.size(), 0);
+    for (const auto& trail : prev.pack->trails)
+    {
+        if (trail.source >= stale.size()) return reuse;
+        std::string norm = TacoParser::NormalisePath(trail.trailDataFile);
+        const PackArchive::Entry* entry = archive.Find(norm);
+        auto old = prev.trailFileCrcs.find(norm);
+        if (!entry || old == prev.trailFileCrcs.end() || old->second != entry->crc32)
+            stale[trail.source] = 1;
+    }
+
+    std::unordered_map<std::string, int> prevIndex;
+    for (size_t i = 0; i < prev.sources.size(); ++i)
+        prevIndex.emplace(prev.sources[i].file, (int)i);
+
+    for (size_t i = 0; i < xmlEntries.size(); ++i)
+    {
+        auto it = prevIndex.find(xmlEntries[i]->name);
+        if (it == prevIndex.end()) continue;
+        if (prev.sources[it->second].crc32 == xmlEntries[i]->crc32 && !stale[it->second])
+            reuse[i] = it->second;
+    }
+    return reuse;
+}
+
+// The category tree is merged across every file, so a previous tree is only
+// valid if the same files declare the same categories in the same order.
+static bool SameCategorySources(const std::vector<PackSource>& a, const std::vector<PackSource>& b)
+{
+    size_t i = 0, j = 0;
+    for (;;)
+    {
+        while (i < a.size() && a[i].categoryHash == 0) ++i;
+        while (j < b.size() && b[j].categoryHash == 0) ++j;
+        if (i == a.size() || j == b.size()) return i == a.size() && j == b.size();
+        if (a[i].file != b[j].file || a[i].categoryHash != b[j].categoryHash) return false;
+        ++i; ++j;
+    }
+}
+
+// Parse one pack from its XML on the pool.  Each stage fans out into
+// independent tasks:
+//   1. one task per XML entry — inflate + parse the DOM in place
+//   2. merge every category tree (serial, archive order, so it's deterministic)
+//   3. one task per document — resolve its POIs / Trails against the tree
+//   4. one task per Trail — inflate + read its .trl binary, build its chunks
+//   5. merge — concatenate in document order, drop unloadable trails
+// Every file is parsed exactly once and the documents are kept until step 3
+// is done, so categories declared in one file resolve for markers in another.
+//
+// When prev (the same pack from the last load) is given, XML files whose CRC
+// hasn't changed are not parsed again: their POIs and loaded trails are
+// copied from prev.  That needs the category tree to be unchanged too — if a
+// file that declares categories changed, every file is parsed as usual.
+void PackLoader::ParsePack(TaskPool& pool, const PackArchive& archive, const PrevPack* prev,
+                           TacoPack& pack, LoadProfile::PackProfile& prof, ParseStats& result)
+{
+    std::vector<const PackArchive::Entry*> xmlEntries;
+    for (const auto& entry : archive.Entries())
+        if (HasExtension(entry.name, ".xml")) xmlEntries.push_back(&entry);
+
+    const size_t fileCount = xmlEntries.size();
+    std::vector<int> reuse = prev ? MatchUnchangedSources(archive, *prev, xmlEntries)
+                                  : std::vector<int>(fileCount, -1);
+
+    pack.sources.resize(fileCount);
+    for (size_t i = 0; i < fileCount; ++i)
+    {
+        pack.sources[i].file  = xmlEntries[i]->name;
+        pack.sources[i].crc32 = xmlEntries[i]->crc32;
+        if (reuse[i] >= 0)
+            pack.sources[i].categoryHash = prev->sources[reuse[i]].categoryHash;
+    }
+
+    // ── 1. Inflate + parse every XML entry that isn't carried over ──────────
+    std::vector<TacoParser::XmlDocument> docs(fileCount);
+    auto parseDocs = [&](bool carried)
+    {
+        TaskPool::TaskGroup group;
+        for (size_t i = 0; i < fileCount; ++i)
+        {
+            if ((reuse[i] >= 0) != carried) continue;
+            pool.Submit(group, [&, i]
+            {
+                std::vector<uint8_t> buf;
+                bool read;
+                {
+                    LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::Inflate);
+                    read        = archive.Read(*xmlEntries[i], buf);
+                    stage.bytes = buf.size();
+                    stage.items = 1;
+                }
+                LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::XmlParse);
+                stage.bytes = buf.size();
+                stage.items = 1;
+                if (read)
+                    TacoParser::LoadXmlDocument(std::move(buf), docs[i]);
+                pack.sources[i].categoryHash = TacoParser::CategoryHash(docs[i]);
+            });
+        }
+        pool.Wait(group);
+        LoadProfile::SampleMemory();
+    };
+    parseDocs(false);
+
+    // ── 2. Build the complete category tree from every XML file ──────────────
+    if (prev && SameCategorySources(prev->sources, pack.sources))
+    {
+        LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::Categories);
+        pack.categories = prev->categories;
+    }
+    else
+    {
+        // The tree changed, so markers carried over may now inherit different
+        // attributes: parse the remaining files too and resolve everything.
+        if (std::any_of(reuse.begin(), reuse.end(), [](int r){ return r >= 0; }))
+        {
+            parseDocs(true);
+            std::fill(reuse.begin(), reuse.end(), -1);
+        }
+        LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::Categories);
+        for (const auto& doc : docs)
+            TacoParser::ParseDocumentCategories(doc, pack);
+    }
+
+    // ── 3. Resolve POIs and Trails, one task per document ───────────────────
+    struct DocResult
+    {
+        std::vector<Poi>           pois;
+        std::vector<Trail>         trails;
+        std::vector<MarkerAttribs> attribs;   // document-local attribute table
+        TacoParser::TrailLoadStats stats;
+    };
+    std::vector<DocResult> parts(fileCount);
+    size_t reparsed = 0;
+    {
+        TaskPool::TaskGroup group;
+        for (size_t i = 0; i < fileCount; ++i)
+        {
+            if (reuse[i] >= 0) continue;
+            ++reparsed;
+            pool.Submit(group, [&, i]
+            {
+                LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::PoiResolve);
+                TacoParser::ParseDocumentPois(docs[i], pack.categories,
+                                              parts[i].pois, parts[i].trails,
+                                              parts[i].attribs, &parts[i].stats);
+                stage.items = parts[i].pois.size() + parts[i].trails.size();
+                docs[i] = TacoParser::XmlDocument{};   // free the DOM early
+            });
+        }
+        pool.Wait(group);
+    }
+    LoadProfile::SampleMemory();
+    docs.clear();
+
+    // Carried-over markers keep their place in source order.  Their trails
+    // are already loaded and skip step 4; their attrib indices still refer to
+    // prev->pack->attribs until the merge below.
+    const auto mergeStart = std::chrono::steady_clock::now();
+    std::vector<std::vector<Trail>> keptTrails(fileCount);
+    if (reparsed < fileCount)
+    {
+        std::vector<int> target(prev->sources.size(), -1);
+        for (size_t i = 0; i < fileCount; ++i)
+            if (reuse[i] >= 0) target[reuse[i]] = (int)i;
+
+        for (const auto& poi : prev->pack->pois)
+            if (target[poi.source] >= 0) parts[target[poi.source]].pois.push_back(poi);
+        for (const auto& trail : prev->pack->trails)
+            if (target[trail.source] >= 0) keptTrails[target[trail.source]].push_back(trail);
+    }
+
+    TacoParser::TrailLoadStats stats;
+    size_t poiCount = 0, trailCount = 0;
+    for (size_t i = 0; i < fileCount; ++i)
+    {
+        stats.Merge(parts[i].stats);
+        poiCount   += parts[i].pois.size();
+        trailCount += parts[i].trails.size() + keptTrails[i].size();
+    }
+
+    // Every document's attribute table (or prev's, for carried-over markers)
+    // is interned into the pack's, so equal records are shared pack-wide.
+    constexpr uint32_t kUnmapped = 0xFFFFFFFFu;
+    TacoParser::AttribInterner interner(pack.attribs);
+    std::vector<uint32_t> prevRemap(prev ? prev->pack->attribs.size() : 0, kUnmapped);
+    std::vector<uint32_t> docRemap;
+    auto mapAttrib = [&](size_t doc, uint32_t a) -> uint32_t
+    {
+        if (reuse[doc] < 0) return docRemap[a];
+        uint32_t& m = prevRemap[a];
+        if (m == kUnmapped) m = interner.Intern(prev->pack->attribs[a]);
+        return m;
+    };
+
+    pack.pois.reserve(poiCount);
+    std::vector<Trail>       trails;
+    std::vector<TrailResult> results;
+    trails.reserve(trailCount);
+    results.reserve(trailCount);
+    for (size_t i = 0; i < fileCount; ++i)
+    {
+        docRemap.resize(parts[i].attribs.size());
+        for (size_t a = 0; a < parts[i].attribs.size(); ++a)
+            docRemap[a] = interner.Intern(parts[i].attribs[a]);
+
+        for (auto& poi : parts[i].pois)
+        {
+            poi.source = (uint32_t)i;
+            poi.attrib = mapAttrib(i, poi.attrib);
+            pack.pois.push_back(std::move(poi));
+        }
+        for (auto& trail : keptTrails[i])
+        {
+            trail.source = (uint32_t)i;
+            trail.attrib = mapAttrib(i, trail.attrib);
+            trails.push_back(std::move(trail));
+            results.push_back(TrailResult::Loaded);
+        }
+        for (auto& trail : parts[i].trails)
+        {
+            trail.source = (uint32_t)i;
+            trail.attrib = mapAttrib(i, trail.attrib);
+            trails.push_back(std::move(trail));
+            results.push_back(TrailResult::BinaryFailed);
+        }
+    }
+    parts.clear();
+    keptTrails.clear();
+    prof.Add(LoadProfile::Stage::PoiResolve, LoadProfile::ElapsedNs(mergeStart));
+
+    // ── 4. Load trail binaries ───────────────────────────────────────────────
+    std::vector<char> fresh(trails.size(), 0);
+    {
+        TaskPool::TaskGroup group;
+        for (size_t i = 0; i < trails.size(); ++i)
+        {
+            if (results[i] == TrailResult::Loaded) continue;
+            fresh[i] = 1;
+            pool.Submit(group, [&, i]{ results[i] = LoadTrail(archive, trails[i], prof); });
+        }
+        pool.Wait(group);
+    }
+    LoadProfile::SampleMemory();
+
+    // ── 5. Merge ─────────────────────────────────────────────────────────────
+    pack.trails.reserve(trails.size());
+    for (size_t i = 0; i < trails.size(); ++i)
+    {
+        switch (results[i])
+        {
+        case TrailResult::Loaded:
+            if (fresh[i]) ++stats.loaded;
+            pack.trails.push_back(std::move(trails[i]));
+            break;
+        case TrailResult::FileNotFound:
+            ++stats.fileNotFound;
+            if (stats.sampleMissingPath.empty())
+                stats.sampleMissingPath = trails[i].trailDataFile;
+            break;
+        case TrailResult::BinaryFailed: ++stats.binaryFailed; break;
+        case TrailResult::NoMapId:      ++stats.noMapId;      break;
+        case TrailResult::NoPoints:     ++stats.noPoints;     break;
+        }
+    }
+
+    result.fileCount = fileCount;
+    result.reparsed  = reparsed;
+    result.trails    = std::move(stats);
+}
+
+void PackLoader::RecordTrailCrcs(const PackArchive& archive, TacoPack& pack)
+{
+    pack.trailFileCrcs.clear();
+    for (const auto& entry : archive.Entries())
+        if (HasExtension(entry.name, ".trl"))
+            pack.trailFileCrcs.emplace(entry.name, entry.crc32);
+}
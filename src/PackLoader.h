@@ -0,0 +1,66 @@
+#pragma once
+#include "TacoPack.h"
+#include "TacoParser.h"
+#include "LoadProfile.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class PackArchive;
+class TaskPool;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// PackLoader
+//
+// Builds a TacoPack from an open .taco archive: the XML path the loader takes
+// when a pack has no current cache.  Nothing here talks to Nexus — results and
+// diagnostics are returned so PackManager can log them, and pathing_bench /
+// the tests run exactly the code the addon does.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace PackLoader
+{
+
+// What a load reads of the pack it may reuse, taken under the caller's pack
+// lock before the load starts.  The UI flips enabled flags in the category
+// tree at any time (under that lock), so the tree is copied along with the
+// small identity fields.  pois / trails / attribs are read in place through
+// pack: nothing writes them once a pack is adopted, and the caller only
+// replaces its packs while the loader waits in the hand-off.
+struct PrevPack
+{
+    uint64_t                                  archiveSize  = 0;
+    uint64_t                                  archiveMtime = 0;
+    uint64_t                                  contentHash  = 0;
+    std::vector<PackSource>                   sources;
+    std::unordered_map<std::string, uint32_t> trailFileCrcs;
+    std::vector<MarkerCategory>               categories;
+    const TacoPack*                           pack = nullptr;   // pois / trails / attribs only
+};
+
+PrevPack SnapshotPrev(const TacoPack& pack);
+
+// What ParsePack did, for the caller's log.
+struct ParseStats
+{
+    size_t                     fileCount = 0;   // XML files in the archive
+    size_t                     reparsed  = 0;   // of those, parsed rather than carried over
+    TacoParser::TrailLoadStats trails;
+};
+
+// Parse one pack from its XML on the pool, filling sources, categories,
+// attribs, POIs and loaded trails (points, arc lengths, chunks and LODs).
+// prev, if given, is the same pack from the last load: XML files whose CRC
+// hasn't changed are carried over from it instead of parsed again.
+void ParsePack(TaskPool& pool, const PackArchive& archive, const PrevPack* prev,
+               TacoPack& pack, LoadProfile::PackProfile& prof, ParseStats& stats);
+
+// Remember every .trl entry's CRC so the next reload can tell which trails
+// need to be read again.
+void RecordTrailCrcs(const PackArchive& archive, TacoPack& pack);
+
+// True if a normalised archive path ends in ext (e.g. ".xml").
+bool HasExtension(const std::string& normPath, const char* ext);
+
+} // namespace PackLoader
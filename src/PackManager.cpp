@@ -1,19 +1,32 @@
 #include "PackManager.h"
 #include "TacoParser.h"
+#include "PackArchive.h"
+#include "PackCache.h"
+#include "PackLoader.h"
+#include "TaskPool.h"
+#include "IconAtlas.h"
+#include "LoadProfile.h"
+#include "Settings.h"
 #include "Shared.h"
 
-#include <miniz.h>
 #include <nlohmann/json.hpp>
 
 #include <windows.h>
 #include <shlwapi.h>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <sstream>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
@@ -29,14 +42,115 @@ namespace
     std::atomic<int>       g_TotalPois{0};
     std::atomic<int>       g_TotalTrails{0};
 
+    // Advances whenever the set of visible entities may have changed (new
+    // packs adopted, pack / category toggled).  See PackManager::Generation().
+    std::atomic<uint64_t>  g_Generation{1};
+
     // Background loading thread handle (joined on reload/shutdown)
     std::thread            g_LoadThread;
-
-    // Textures that need to be registered from the main / render thread.
-    // Background loader populates this; FlushPendingTextures drains it.
-    struct PendingTex { std::string texId; std::string absPath; };
-    std::vector<PendingTex> g_PendingTextures;
+    std::mutex             g_ReloadMutex;          // serialises Reload() / load-thread exit
+    std::atomic<bool>      g_ReloadRequested{false};
+
+    // Packs folder watcher (auto reload)
+    std::thread            g_WatchThread;
+    HANDLE                 g_WatchStop = nullptr;
+    constexpr DWORD        kWatchSettleMs = 250;
+    constexpr DWORD        kWatchPollMs   = 1000;
+
+    // Outcome of loading one pack.  Unchanged means the previous pack is
+    // still current and is kept as is.
+    enum class PackResult : uint8_t { Failed, Loaded, Unchanged };
+
+    // A finished load, handed from the loader to the render thread, which
+    // swaps it into g_Packs in Update().  Swapping there means nothing the
+    // renderer or UI holds into g_Packs is ever freed mid-frame.  The loader
+    // blocks until the hand-off is taken (or Shutdown() abandons it).
+    struct PendingLoad
+    {
+        std::vector<TacoPack>   packs;
+        std::vector<PackResult> results;
+        std::vector<int>        prevIndex;   // g_Packs index reused for Unchanged
+    };
+    PendingLoad             g_PendingLoad;
+    std::atomic<bool>       g_PendingReady{false};
+    bool                    g_ShuttingDown = false;
+    std::mutex              g_PendingMutex;
+    std::condition_variable g_PendingCv;
+
+    // Where each texture slot's image comes from, indexed by slot.  The
+    // loader appends an entry when it assigns a slot; the render thread
+    // registers it with the host once a map needs it.  image holds the
+    // encoded file for textures built by the loader (atlas pages) until it is
+    // registered; otherwise the texture is the pack entry packFile / entry.
+    // imageDropped marks a page retired before it was ever registered.
+    struct TexSource
+    {
+        std::string          texId;
+        std::string          packFile;
+        std::string          entry;
+        std::vector<uint8_t> image;
+        bool                 imageDropped = false;
+    };
+    std::vector<TexSource>  g_TexSources;
     std::mutex              g_PendingTexMutex;
+
+    // Atlas page slots of each pack's current content, by pack file.  A
+    // reload that packs different pages retires the old ones: their PNGs are
+    // dropped once the packs drawing with them are gone (AdoptPendingLoad).
+    // Both under g_PendingTexMutex.
+    std::unordered_map<std::string, std::vector<uint32_t>> g_AtlasSlots;
+    std::vector<uint32_t>                                  g_RetiredAtlasSlots;
+
+    // Texture slots.  A texture id gets a slot the first time a pack refers to
+    // it and keeps it for the lifetime of the addon, so markers carried over a
+    // reload keep theirs.  The id map and sources are filled by the loader and
+    // the Nexus load callback reads the map, all under g_PendingTexMutex; the
+    // resource and state tables are only touched on the render thread
+    // (FlushPendingTextures).
+    struct ReadyTex { uint32_t slot; void* resource; };   // resource null: the host failed
+    std::unordered_map<std::string, uint32_t> g_TexSlotIds;   // texId → slot
+    std::vector<ReadyTex>                     g_ReadyTextures; // from OnTextureLoaded
+    std::vector<void*>                        g_TexSlotResources;
+
+    // Profile of the last finished load (see LoadProfile).
+    std::shared_ptr<const LoadProfile::Report> g_LoadReport;
+    std::mutex                                 g_LoadReportMutex;
+
+    // Render-thread demand tracking.  Entering a map queues its slots that
+    // aren't resident; nothing is ever unloaded, as the host API has no call
+    // to free a registered texture.  The queue only ever holds the current
+    // map's slots and is drained within a per-frame budget.  A slot whose image can't be read,
+    // that the host fails to load, or whose load hasn't come back within
+    // kTexRequestTimeout frames goes back to Idle and is queued again; after
+    // kTexMaxAttempts failures in a row it is Failed until the next load.
+    enum class TexState : uint8_t { Idle, Queued, Requested, Resident, Failed };
+    struct SlotState
+    {
+        TexState state        = TexState::Idle;
+        uint8_t  failures     = 0;        // failed registrations in a row
+        uint32_t lastVisit    = 0;        // g_MapVisit of the last map using it
+        uint32_t requestFrame = 0;        // g_TexFrame it was Requested in
+    };
+    constexpr uint8_t       kTexMaxAttempts = 3;
+    constexpr uint32_t      kTexRequestTimeout = 600;  // frames, ~10 s
+    std::vector<uint32_t>   g_TexInFlight;             // slots Requested, oldest first
+    uint32_t                g_TexFrame = 0;            // FlushPendingTextures calls
+    bool                    g_DemandStale = false;     // a failed slot wants requeueing
+    std::vector<SlotState>  g_SlotStates;
+    std::vector<uint32_t>   g_TexQueue;                // slots, ascending
+    size_t                  g_TexQueueHead = 0;        // [0, head) are done
+    uint32_t                g_DemandMap = 0;
+    uint64_t                g_DemandGen = 0;
+    uint32_t                g_MapVisit  = 0;
+    PackManager::TextureQueueStats g_TexStats;
+    std::chrono::steady_clock::time_point g_TexRateStart;
+    size_t                  g_TexRateCount = 0;
+
+    // Archives standalone textures are read from, by pack file.  They stay
+    // mapped across frames while the queue has work — a budgeted flush
+    // usually stops mid-pack — and are closed once it drains or the packs
+    // are replaced, since a mapped archive can't be replaced on disk.
+    std::unordered_map<std::string, std::unique_ptr<PackArchive>> g_TexArchives;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -61,214 +175,188 @@ static std::string PacksDirStatic()
     return dir;
 }
 
-static std::string ExtractDirForPack(const std::string& packFile)
-{
-    // Extract to <addondir>/extract/<packname_no_ext>/
-    std::string base = packFile;
-    // Grab just the filename without extension
-    std::string filename = base;
-    auto backslash = base.rfind('\\');
-    auto fwdslash  = base.rfind('/');
-    size_t sep = std::string::npos;
-    if (backslash != std::string::npos) sep = backslash;
-    if (fwdslash  != std::string::npos) sep = (sep == std::string::npos) ? fwdslash : std::max(sep, fwdslash);
-    if (sep != std::string::npos) filename = base.substr(sep + 1);
-    // Remove extension
-    auto dot = filename.rfind('.');
-    if (dot != std::string::npos) filename = filename.substr(0, dot);
-
-    // Sanitise filename for use as directory name
-    for (char& c : filename)
-        if (c == ' ' || c == ':' || c == '*' || c == '?' || c == '"' ||
-            c == '<' || c == '>' || c == '|') c = '_';
-
-    std::string dir = AddonDataDirStatic() + "\\extract\\" + filename;
-    // Create nested directories
-    CreateDirectoryA((AddonDataDirStatic() + "\\extract").c_str(), nullptr);
+static std::string CacheDirStatic()
+{
+    std::string dir = AddonDataDirStatic();
+    if (dir.empty()) return "";
+    dir += "\\cache";
     CreateDirectoryA(dir.c_str(), nullptr);
     return dir;
 }
 
-// Recursively create directories for a file path.
-static void EnsureDirectoryForFile(const std::string& filePath)
+static std::string MakeTexId(const std::string& packName, const std::string& normPath)
 {
-    std::string dir = filePath;
-    auto sep = dir.rfind('\\');
-    if (sep == std::string::npos) sep = dir.rfind('/');
-    if (sep != std::string::npos)
-    {
-        dir = dir.substr(0, sep);
-        // Create all parent directories
-        for (size_t i = 0; i < dir.size(); ++i)
-        {
-            if (dir[i] == '\\' || dir[i] == '/')
-            {
-                std::string partial = dir.substr(0, i);
-                if (!partial.empty()) CreateDirectoryA(partial.c_str(), nullptr);
-            }
-        }
-        CreateDirectoryA(dir.c_str(), nullptr);
-    }
+    std::string texId = "PATHING_" + packName + "_" + normPath;
+    std::replace(texId.begin(), texId.end(), '/', '_');
+    std::replace(texId.begin(), texId.end(), '\\', '_');
+    std::replace(texId.begin(), texId.end(), '.', '_');
+    std::replace(texId.begin(), texId.end(), ' ', '_');
+    return texId;
 }
 
-// Extract all files from a .taco (ZIP) archive into extractDir.
-// Fills pack.extractedFiles.  Returns false if the archive can't be opened.
-static bool ExtractTacoPack(const std::string& tacoPath, const std::string& extractDir, TacoPack& pack)
+// Slot of texId, assigning the next free one if it has none yet.
+// Caller holds g_PendingTexMutex.
+static uint32_t TexSlotFor(const std::string& texId, bool& isNew)
 {
-    mz_zip_archive zip{};
-    if (!mz_zip_reader_init_file(&zip, tacoPath.c_str(), 0))
-        return false;
-
-    mz_uint fileCount = mz_zip_reader_get_num_files(&zip);
-    for (mz_uint i = 0; i < fileCount; ++i)
-    {
-        mz_zip_archive_file_stat stat{};
-        if (!mz_zip_reader_file_stat(&zip, i, &stat)) continue;
-        if (mz_zip_reader_is_file_a_directory(&zip, i)) continue;
+    auto it = g_TexSlotIds.emplace(texId, (uint32_t)g_TexSlotIds.size());
+    isNew = it.second;
+    return it.first->second;
+}
 
-        std::string entryName = stat.m_filename;
-        std::string normed    = TacoParser::NormalisePath(entryName);
-        std::string destPath  = extractDir + "\\" + normed;
-        // Replace forward slashes with backslashes for Win32 directory creation
-        std::replace(destPath.begin(), destPath.end(), '/', '\\');
+// Nexus texture-load callback: hands the resource to the render thread.
+static void OnTextureLoaded(const char* identifier, Texture_t* texture)
+{
+    if (!identifier) return;
+    std::lock_guard<std::mutex> lock(g_PendingTexMutex);
+    auto it = g_TexSlotIds.find(identifier);
+    if (it != g_TexSlotIds.end())
+        g_ReadyTextures.push_back({it->second, texture ? texture->Resource : nullptr});
+}
 
-        EnsureDirectoryForFile(destPath);
+// Builds the pack's icon atlas, assigns texture slots to its icons and
+// trails, and records where the textures not seen before come from.  Icons
+// are decoded and packed here; icons that can't be (too large, or a format
+// stb_image doesn't read) stay standalone textures, read by archive entry
+// name and inflated only when a map needs them.
+// Called from the background loader — does NOT touch the Nexus API.
+static void PreparePackTextures(TaskPool& pool, const PackArchive& archive, TacoPack& pack,
+                                LoadProfile::PackProfile& prof)
+{
+    LoadProfile::ScopedStage stage(prof, LoadProfile::Stage::Textures);
 
-        // Only extract if not already extracted (avoids re-writing unchanged files)
-        if (GetFileAttributesA(destPath.c_str()) == INVALID_FILE_ATTRIBUTES)
+    // Archive entries per attribute record — markers sharing a record share
+    // its icon, so each distinct path is normalised and looked up once.
+    const size_t n = pack.attribs.size();
+    std::vector<std::string> iconEntries(n), trailEntries(n);
+    for (size_t a = 0; a < n; ++a)
+    {
+        const MarkerAttribs& attribs = pack.attribs[a];
+        if (!attribs.iconFile.empty())
         {
-            if (!mz_zip_reader_extract_to_file(&zip, i, destPath.c_str(), 0))
-            {
-                // If file extraction failed, skip it
-                continue;
-            }
+            std::string normIcon = TacoParser::NormalisePath(attribs.iconFile);
+            if (archive.Find(normIcon)) iconEntries[a] = std::move(normIcon);
+        }
+        if (!attribs.texture.empty())
+        {
+            std::string normTex = TacoParser::NormalisePath(attribs.texture);
+            if (archive.Find(normTex)) trailEntries[a] = std::move(normTex);
         }
-
-        pack.extractedFiles[normed] = destPath;
     }
 
-    mz_zip_reader_end(&zip);
-    return true;
-}
-
-// Parse all XML files within an extracted pack directory.
-// Uses a two-pass strategy so that MarkerCategory definitions from any file
-// are always available when POIs and Trails in other files are resolved —
-// regardless of the iteration order of the unordered_map.
-static void ParseExtractedXmls(TacoPack& pack)
-{
-    // Collect XML contents up-front (avoids re-opening files for pass 2).
-    std::vector<std::string> xmlContents;
-    xmlContents.reserve(32);
+    // Distinct icon files, decoded in parallel.
+    constexpr uint32_t kNoIcon = 0xFFFFFFFFu;
+    std::vector<std::string>                  icons;
+    std::vector<uint32_t>                     iconOf(n, kNoIcon);   // attrib → icons index
+    std::unordered_map<std::string, uint32_t> iconIndex;
+    for (size_t a = 0; a < n; ++a)
+    {
+        if (iconEntries[a].empty()) continue;
+        auto it = iconIndex.emplace(iconEntries[a], (uint32_t)icons.size());
+        if (it.second) icons.push_back(iconEntries[a]);
+        iconOf[a] = it.first->second;
+    }
 
-    for (const auto& [normPath, absPath] : pack.extractedFiles)
+    std::vector<IconAtlas::Image> images(icons.size());
     {
-        if (normPath.size() < 4) continue;
-        std::string ext = normPath.substr(normPath.size() - 4);
-        std::transform(ext.begin(), ext.end(), ext.begin(),
-                       [](unsigned char c){ return (char)std::tolower(c); });
-        if (ext != ".xml") continue;
+        TaskPool::TaskGroup group;
+        for (size_t i = 0; i < icons.size(); ++i)
+        {
+            pool.Submit(group, [&, i]
+            {
+                std::vector<uint8_t> bytes;
+                if (archive.Read(icons[i], bytes))
+                    IconAtlas::Decode(bytes.data(), bytes.size(), images[i]);
+                prof.Add(LoadProfile::Stage::Textures, 0, bytes.size());
+            });
+        }
+        pool.Wait(group);
+    }
 
-        std::ifstream f(absPath);
-        if (!f.is_open()) continue;
+    std::vector<IconAtlas::Page>      pages;
+    std::vector<IconAtlas::Placement> placements;
+    IconAtlas::Pack(images, pages, placements);
+    images.clear();
 
-        xmlContents.emplace_back((std::istreambuf_iterator<char>(f)),
-                                  std::istreambuf_iterator<char>());
+    std::vector<std::vector<uint8_t>> pagePngs(pages.size());
+    {
+        TaskPool::TaskGroup group;
+        for (size_t p = 0; p < pages.size(); ++p)
+            pool.Submit(group, [&, p]{ IconAtlas::EncodePng(pages[p], pagePngs[p]); });
+        pool.Wait(group);
     }
+    pages.clear();
 
-    // Pass 1 — build the complete category tree from every XML file.
-    for (const auto& content : xmlContents)
-        TacoParser::ParseXmlCategories(content, pack);
-
-    // Pass 2 — parse POIs and Trails (category tree is now fully populated).
-    TacoParser::TrailLoadStats stats;
-    for (const auto& content : xmlContents)
-        TacoParser::ParseXmlPois(content, pack, &stats);
+    LoadProfile::SampleMemory();
+    stage.items = icons.size() + pagePngs.size();
+    std::lock_guard<std::mutex> lock(g_PendingTexMutex);
 
-    // Log trail load diagnostics so failures can be diagnosed.
-    if (APIDefs)
+    // Atlas pages.  The content hash keeps ids of differently packed pages
+    // apart across reloads — the host has no way to replace a texture.
+    char hashHex[17];
+    snprintf(hashHex, sizeof(hashHex), "%016llx", (unsigned long long)pack.contentHash);
+    std::vector<uint32_t> pageSlots(pagePngs.size(), kNoTexSlot);
+    for (size_t p = 0; p < pagePngs.size(); ++p)
     {
-        if (stats.xmlTrailNodes == 0)
+        if (pagePngs[p].empty()) continue;
+        std::string texId = MakeTexId(pack.name, std::string("atlas_") + hashHex + "_" + std::to_string(p));
+        bool isNew;
+        pageSlots[p] = TexSlotFor(texId, isNew);
+        if (isNew)
         {
-            APIDefs->Log(LOGL_INFO, "Pathing",
-                ("Trail parse [" + pack.name + "]: 0 <Trail> elements in any XML").c_str());
+            g_TexSources.push_back({std::move(texId), pack.filePath, "", std::move(pagePngs[p]), false});
         }
-        else
+        else if (g_TexSources[pageSlots[p]].imageDropped)
         {
-            std::string msg = "Trail parse [" + pack.name + "]: "
-                + std::to_string(stats.xmlTrailNodes) + " nodes  "
-                + std::to_string(stats.loaded)        + " loaded  "
-                + std::to_string(stats.noDataAttr)    + " no-attr  "
-                + std::to_string(stats.fileNotFound)  + " file-notfound  "
-                + std::to_string(stats.binaryFailed)  + " binary-fail  "
-                + std::to_string(stats.noMapId)        + " no-mapid  "
-                + std::to_string(stats.noPoints)       + " no-points";
-            APIDefs->Log(LOGL_INFO, "Pathing", msg.c_str());
-
-            if (!stats.sampleMissingPath.empty())
-            {
-                APIDefs->Log(LOGL_WARNING, "Pathing",
-                    ("  Sample missing path: \"" + stats.sampleMissingPath + "\"").c_str());
-
-                // Show a few actual extractedFiles keys so the key format is visible.
-                int shown = 0;
-                for (const auto& [k, v] : pack.extractedFiles)
-                {
-                    if (k.size() < 4) continue;
-                    std::string ext = k.substr(k.size() - 4);
-                    if (ext == ".trl" || ext == ".xml")
-                    {
-                        APIDefs->Log(LOGL_WARNING, "Pathing",
-                            ("  ExtractKey sample: \"" + k + "\"").c_str());
-                        if (++shown >= 4) break;
-                    }
-                }
-            }
+            // Content seen before whose page was retired unregistered.
+            TexSource& src   = g_TexSources[pageSlots[p]];
+            src.image        = std::move(pagePngs[p]);
+            src.imageDropped = false;
         }
     }
-}
 
-// Collect all icon / trail texture paths from a pack into the pending queue.
-// Called from the background loader — does NOT touch the Nexus API.
-static void QueuePackTextures(TacoPack& pack)
-{
-    std::lock_guard<std::mutex> lock(g_PendingTexMutex);
+    std::vector<uint32_t>& current = g_AtlasSlots[pack.filePath];
+    for (uint32_t slot : current)
+        if (std::find(pageSlots.begin(), pageSlots.end(), slot) == pageSlots.end())
+            g_RetiredAtlasSlots.push_back(slot);
+    current.clear();
+    for (uint32_t slot : pageSlots)
+        if (slot != kNoTexSlot) current.push_back(slot);
 
-    for (auto& poi : pack.pois)
+    // Standalone textures: trails, and icons that didn't make it into a page.
+    auto standaloneSlot = [&](const std::string& entry)
     {
-        if (poi.attribs.iconFile.empty() || !poi.texId.empty()) continue;
-
-        std::string normIcon = TacoParser::NormalisePath(poi.attribs.iconFile);
-        std::string absPath  = pack.ResolveFile(normIcon);
-        if (absPath.empty()) continue;
-
-        std::string texId = "PATHING_" + pack.name + "_" + normIcon;
-        std::replace(texId.begin(), texId.end(), '/', '_');
-        std::replace(texId.begin(), texId.end(), '\\', '_');
-        std::replace(texId.begin(), texId.end(), '.', '_');
-        std::replace(texId.begin(), texId.end(), ' ', '_');
-
-        poi.texId = texId;
-        g_PendingTextures.push_back({texId, absPath});
-    }
-
-    for (auto& trail : pack.trails)
+        std::string texId = MakeTexId(pack.name, entry);
+        bool isNew;
+        uint32_t slot = TexSlotFor(texId, isNew);
+        if (isNew)
+            g_TexSources.push_back({std::move(texId), pack.filePath, entry, {}, false});
+        return slot;
+    };
+
+    std::vector<IconRef> iconRefs(icons.size());
+    for (size_t i = 0; i < icons.size(); ++i)
     {
-        if (trail.attribs.texture.empty() || !trail.texId.empty()) continue;
-
-        std::string normTex = TacoParser::NormalisePath(trail.attribs.texture);
-        std::string absPath = pack.ResolveFile(normTex);
-        if (absPath.empty()) continue;
+        const IconAtlas::Placement& pl = placements[i];
+        IconRef& ref = iconRefs[i];
+        if (pl.page != IconAtlas::kNoPage && pageSlots[pl.page] != kNoTexSlot)
+        {
+            ref.texSlot = pageSlots[pl.page];
+            ref.u0 = pl.u0; ref.v0 = pl.v0; ref.u1 = pl.u1; ref.v1 = pl.v1;
+        }
+        else
+        {
+            ref.texSlot = standaloneSlot(icons[i]);
+        }
+    }
 
-        std::string texId = "PATHING_" + pack.name + "_" + normTex;
-        std::replace(texId.begin(), texId.end(), '/', '_');
-        std::replace(texId.begin(), texId.end(), '\\', '_');
-        std::replace(texId.begin(), texId.end(), '.', '_');
-        std::replace(texId.begin(), texId.end(), ' ', '_');
+    pack.icons.assign(n, IconRef{});
+    for (size_t a = 0; a < n; ++a)
+        if (iconOf[a] != kNoIcon) pack.icons[a] = iconRefs[iconOf[a]];
 
-        trail.texId = texId;
-        g_PendingTextures.push_back({texId, absPath});
-    }
+    std::vector<uint32_t> trailSlots(n, kNoTexSlot);
+    for (size_t a = 0; a < n; ++a)
+        if (!trailEntries[a].empty()) trailSlots[a] = standaloneSlot(trailEntries[a]);
+    for (auto& trail : pack.trails) trail.texSlot = trailSlots[trail.attrib];
 }
 
 // Derive a friendly pack name from the file path.
@@ -352,83 +440,380 @@ void PackManager::SaveCategoryState()
     std::ofstream(path) << state.dump(2);
 }
 
-void PackManager::LoadCategoryState()
+static bool ReadCategoryState(json& state)
 {
     std::string path = CategoryStatePath();
-    if (path.empty()) return;
+    if (path.empty()) return false;
 
     std::ifstream f(path);
-    if (!f.is_open()) return;
+    if (!f.is_open()) return false;
 
-    json state;
     try { state = json::parse(f); }
-    catch (...) { return; }
+    catch (...) { return false; }
+    return true;
+}
+
+static void ApplyPackState(TacoPack& pack, const json& state)
+{
+    auto it = state.find(pack.name);
+    if (it == state.end()) return;
+    const json& ps = *it;
+    if (ps.contains("_enabled") && ps["_enabled"].is_boolean())
+        pack.enabled = ps["_enabled"].get<bool>();
+    if (ps.contains("categories"))
+        ApplyCategoryState(pack.categories, "", ps["categories"]);
+    pack.RefreshEnabledBits();
+}
+
+void PackManager::LoadCategoryState()
+{
+    json state;
+    if (!ReadCategoryState(state)) return;
 
-    std::lock_guard<std::mutex> lock(g_PacksMutex);
-    for (auto& pack : g_Packs)
     {
-        auto it = state.find(pack.name);
-        if (it == state.end()) continue;
-        const json& ps = *it;
-        if (ps.contains("_enabled") && ps["_enabled"].is_boolean())
-            pack.enabled = ps["_enabled"].get<bool>();
-        if (ps.contains("categories"))
-            ApplyCategoryState(pack.categories, "", ps["categories"]);
+        std::lock_guard<std::mutex> lock(g_PacksMutex);
+        for (auto& pack : g_Packs)
+            ApplyPackState(pack, state);
     }
+    ++g_Generation;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Background loading
 // ─────────────────────────────────────────────────────────────────────────────
 
-static void LoadThread()
+// Log trail load diagnostics so failures can be diagnosed.
+static void LogTrailStats(const PackArchive& archive, const TacoPack& pack,
+                          const TacoParser::TrailLoadStats& stats)
 {
-    std::string packsDir = PacksDirStatic();
-    if (packsDir.empty()) { g_Loading = false; return; }
+    if (APIDefs)
+    {
+        if (stats.xmlTrailNodes == 0)
+        {
+            APIDefs->Log(LOGL_INFO, "Pathing",
+                ("Trail parse [" + pack.name + "]: 0 <Trail> elements in any XML").c_str());
+        }
+        else
+        {
+            std::string msg = "Trail parse [" + pack.name + "]: "
+                + std::to_string(stats.xmlTrailNodes) + " nodes  "
+                + std::to_string(stats.loaded)        + " loaded  "
+                + std::to_string(stats.noDataAttr)    + " no-attr  "
+                + std::to_string(stats.fileNotFound)  + " file-notfound  "
+                + std::to_string(stats.binaryFailed)  + " binary-fail  "
+                + std::to_string(stats.noMapId)        + " no-mapid  "
+                + std::to_string(stats.noPoints)       + " no-points";
+            APIDefs->Log(LOGL_INFO, "Pathing", msg.c_str());
 
-    auto files = FindTacoFiles(packsDir);
-    std::vector<TacoPack> loaded;
-    int totalPois = 0, totalTrails = 0;
+            if (!stats.sampleMissingPath.empty())
+            {
+                APIDefs->Log(LOGL_WARNING, "Pathing",
+                    ("  Sample missing path: \"" + stats.sampleMissingPath + "\"").c_str());
 
-    for (const auto& tacoFile : files)
-    {
-        TacoPack pack;
-        pack.filePath = tacoFile;
-        pack.name     = PackNameFromPath(tacoFile);
+                // Show a few actual archive entry names so the key format is visible.
+                int shown = 0;
+                for (const auto& entry : archive.Entries())
+                {
+                    if (PackLoader::HasExtension(entry.name, ".trl") ||
+                        PackLoader::HasExtension(entry.name, ".xml"))
+                    {
+                        APIDefs->Log(LOGL_WARNING, "Pathing",
+                            ("  ArchiveKey sample: \"" + entry.name + "\"").c_str());
+                        if (++shown >= 4) break;
+                    }
+                }
+            }
+        }
+    }
+}
 
-        std::string extractDir = ExtractDirForPack(tacoFile);
-        if (!ExtractTacoPack(tacoFile, extractDir, pack))
+// Load one pack.  prev is the same file's pack from the last load, if any:
+// when the archive is unchanged it's kept outright, when it has changed only
+// the modified XML files are parsed again.  Otherwise the pack comes from its
+// compiled cache when that's current, or from XML (and the cache refreshed).
+static PackResult LoadPack(TaskPool& pool, const std::string& tacoFile,
+                           const std::string& cacheDir, const PackLoader::PrevPack* prev,
+                           TacoPack& pack, LoadProfile::PackProfile& prof, bool& fromCache)
+{
+    using Stage = LoadProfile::Stage;
+    pack.filePath = tacoFile;
+    pack.name     = PackNameFromPath(tacoFile);
+    fromCache     = false;
+
+    PackArchive    archive;
+    PackCache::Key key;
+    bool           haveKey;
+    {
+        LoadProfile::ScopedStage stage(prof, Stage::ArchiveOpen);
+        if (!archive.Open(tacoFile))
         {
             if (APIDefs)
                 APIDefs->Log(LOGL_WARNING, "Pathing",
-                    ("Failed to extract pack: " + pack.name).c_str());
-            continue;
+                    ("Failed to open pack: " + pack.name).c_str());
+            // Most likely still being written — keep what we had until the
+            // next change notification.
+            return prev ? PackResult::Unchanged : PackResult::Failed;
         }
+        haveKey     = PackCache::ComputeKey(archive, key);
+        stage.bytes = key.archiveSize;
+        stage.items = archive.Entries().size();
+    }
 
-        ParseExtractedXmls(pack);
-        QueuePackTextures(pack);  // actual registration happens on render thread
+    if (haveKey)
+    {
+        // A touched archive with the same content keeps the previous pack too.
+        if (prev && PackCache::Key{prev->archiveSize, prev->archiveMtime, prev->contentHash}.SameContent(key))
+            return PackResult::Unchanged;
 
-        totalPois   += (int)pack.pois.size();
-        totalTrails += (int)pack.trails.size();
+        pack.archiveSize  = key.archiveSize;
+        pack.archiveMtime = key.archiveMtime;
+        pack.contentHash  = key.contentHash;
+    }
 
-        loaded.push_back(std::move(pack));
+    bool        useCache  = haveKey && !cacheDir.empty();
+    std::string cachePath = useCache ? PackCache::CachePathFor(cacheDir, tacoFile) : "";
+    if (useCache)
+    {
+        LoadProfile::ScopedStage stage(prof, Stage::CacheLoad);
+        fromCache   = PackCache::Load(cachePath, key, pack);
+        stage.items = fromCache ? pack.pois.size() + pack.trails.size() : 0;
+    }
 
-        if (APIDefs)
+    if (!fromCache)
+    {
+        PackLoader::ParseStats stats;
+        PackLoader::ParsePack(pool, archive, prev, pack, prof, stats);
+        if (prev && APIDefs)
             APIDefs->Log(LOGL_INFO, "Pathing",
-                ("Loaded pack: " + pack.name).c_str());
+                ("Pack changed [" + pack.name + "]: re-parsed " + std::to_string(stats.reparsed) +
+                 " of " + std::to_string(stats.fileCount) + " XML file(s)").c_str());
+        LogTrailStats(archive, pack, stats.trails);
+
+        LoadProfile::ScopedStage stage(prof, Stage::CacheSave);
+        if (useCache && !PackCache::Save(cachePath, key, pack) && APIDefs)
+            APIDefs->Log(LOGL_WARNING, "Pathing",
+                ("Failed to write pack cache: " + cachePath).c_str());
+    }
+
+    {
+        LoadProfile::ScopedStage stage(prof, Stage::Index);
+        PackLoader::RecordTrailCrcs(archive, pack);
+        pack.IndexCategories();
+        pack.BuildMapIndex();
+        stage.items = pack.trails.size();
     }
+    PreparePackTextures(pool, archive, pack, prof);  // registration happens on render thread
+    LoadProfile::SampleMemory();
 
+    if (APIDefs)
+        APIDefs->Log(LOGL_INFO, "Pathing",
+            ("Loaded pack: " + pack.name + (fromCache ? " (cached)" : "")).c_str());
+    return PackResult::Loaded;
+}
+
+// What the exception being handled says about itself.
+static std::string CurrentExceptionText()
+{
+    try { throw; }
+    catch (const std::exception& e) { return e.what(); }
+    catch (...)                     { return "unknown error"; }
+}
+
+static const char* ResultName(PackResult result, bool fromCache)
+{
+    switch (result)
+    {
+    case PackResult::Loaded:    return fromCache ? "cached" : "loaded";
+    case PackResult::Unchanged: return "unchanged";
+    default:                    return "failed";
+    }
+}
+
+// Writes the load's report next to category_state.json and keeps it for the
+// Pathing window.
+static void PublishLoadReport(LoadProfile::Report report)
+{
+    std::string dir = AddonDataDirStatic();
+    if (!dir.empty() && !LoadProfile::WriteJson(report, dir + "\\load_profile.json") && APIDefs)
+        APIDefs->Log(LOGL_WARNING, "Pathing", "Failed to write load_profile.json");
+
+    auto shared = std::make_shared<const LoadProfile::Report>(std::move(report));
+    std::lock_guard<std::mutex> lock(g_LoadReportMutex);
+    g_LoadReport = std::move(shared);
+}
+
+// Set by Shutdown(); the loader polls it between packs so the game isn't held
+// up waiting for a full load nobody will see.
+static bool ShuttingDown()
+{
+    std::lock_guard<std::mutex> lock(g_PendingMutex);
+    return g_ShuttingDown;
+}
+
+static void LoadAllPacks()
+{
+    std::string packsDir = PacksDirStatic();
+    if (packsDir.empty() || ShuttingDown()) return;
+
+    auto files    = FindTacoFiles(packsDir);
+    auto cacheDir = CacheDirStatic();
+
+    // The previous packs, by file.  g_Packs is only replaced when this thread
+    // hands over its result; what of it the UI can change is snapshotted
+    // here, under the lock the UI writes under.
+    std::vector<int>      prevIndex(files.size(), -1);
+    std::vector<PackLoader::PrevPack> prevs(files.size());
     {
         std::lock_guard<std::mutex> lock(g_PacksMutex);
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            for (size_t j = 0; j < g_Packs.size(); ++j)
+            {
+                if (_stricmp(g_Packs[j].filePath.c_str(), files[i].c_str()) != 0) continue;
+                prevIndex[i] = (int)j;
+                prevs[i]     = PackLoader::SnapshotPrev(g_Packs[j]);
+                break;
+            }
+        }
+    }
+
+    // Every pack is a top-level task; each one fans out further into per-XML
+    // and per-trail tasks on the same pool.
+    const auto loadStart = std::chrono::steady_clock::now();
+    LoadProfile::Report report;
+    report.memStart = LoadProfile::BeginMemoryWatch();
+
+    std::vector<TacoPack>                 packs(files.size());
+    std::vector<PackResult>               results(files.size(), PackResult::Failed);
+    std::vector<LoadProfile::PackProfile> profiles(files.size());
+    std::vector<double>                   wallMs(files.size(), 0.0);
+    std::vector<char>                     fromCache(files.size(), 0);
+    {
+        TaskPool pool;
+        TaskPool::TaskGroup group;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            pool.Submit(group, [&, i]
+            {
+                if (ShuttingDown()) return;     // left Failed; the result is dropped
+                const auto start = std::chrono::steady_clock::now();
+                const PackLoader::PrevPack* prev = prevIndex[i] >= 0 ? &prevs[i] : nullptr;
+                bool cached = false;
+                try
+                {
+                    results[i] = LoadPack(pool, files[i], cacheDir, prev, packs[i], profiles[i], cached);
+                }
+                catch (...)
+                {
+                    // Like an archive that can't be opened: keep what we had.
+                    results[i] = prev ? PackResult::Unchanged : PackResult::Failed;
+                    packs[i]   = TacoPack{};
+                    if (APIDefs)
+                        APIDefs->Log(LOGL_WARNING, "Pathing",
+                            ("Failed to load pack " + PackNameFromPath(files[i]) + ": " +
+                             CurrentExceptionText()).c_str());
+                }
+                fromCache[i] = cached;
+                wallMs[i]    = (double)LoadProfile::ElapsedNs(start) / 1e6;
+            });
+        }
+        pool.Wait(group);
+    }
+    if (ShuttingDown()) return;
+
+    report.finishedAt = LoadProfile::Now();
+    report.wallMs     = (double)LoadProfile::ElapsedNs(loadStart) / 1e6;
+    report.memPeak    = LoadProfile::PeakMemory();
+    report.packs.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+        report.packs.push_back(LoadProfile::Snapshot(profiles[i], PackNameFromPath(files[i]),
+                                                     ResultName(results[i], fromCache[i]), wallMs[i]));
+    profiles.clear();
+    PublishLoadReport(std::move(report));
+
+    // Newly loaded packs get their saved enabled state here, off the render
+    // thread; kept packs already carry theirs.
+    json state;
+    if (ReadCategoryState(state))
+        for (size_t i = 0; i < packs.size(); ++i)
+            if (results[i] == PackResult::Loaded) ApplyPackState(packs[i], state);
+
+    std::unique_lock<std::mutex> lock(g_PendingMutex);
+    g_PendingLoad.packs     = std::move(packs);
+    g_PendingLoad.results   = std::move(results);
+    g_PendingLoad.prevIndex = std::move(prevIndex);
+    g_PendingReady = true;
+
+    g_PendingCv.wait(lock, []{ return !g_PendingReady.load() || g_ShuttingDown; });
+    if (g_PendingReady)
+    {
+        // Shutting down: nothing will render again, just drop the load.
+        g_PendingLoad  = PendingLoad{};
+        g_PendingReady = false;
+    }
+}
+
+// Drops the PNGs of atlas pages no pack draws with any more: pages of
+// content a reload replaced, and of packs that are gone or failed to load.
+// Registered pages have nothing left to drop — the host keeps its copy.
+// Render thread, after g_Packs was replaced.
+static void DropRetiredAtlasPages()
+{
+    std::lock_guard<std::mutex> lock(g_PendingTexMutex);
+    for (auto it = g_AtlasSlots.begin(); it != g_AtlasSlots.end();)
+    {
+        const std::string& file = it->first;
+        const bool live = std::any_of(g_Packs.begin(), g_Packs.end(),
+                                      [&](const TacoPack& p){ return p.filePath == file; });
+        if (live) { ++it; continue; }
+        g_RetiredAtlasSlots.insert(g_RetiredAtlasSlots.end(), it->second.begin(), it->second.end());
+        it = g_AtlasSlots.erase(it);
+    }
+
+    for (uint32_t slot : g_RetiredAtlasSlots)
+    {
+        TexSource& src = g_TexSources[slot];
+        if (src.image.empty()) continue;
+        std::vector<uint8_t>().swap(src.image);
+        src.imageDropped = true;
+    }
+    g_RetiredAtlasSlots.clear();
+}
+
+// Swap the pending load into g_Packs.  Render thread only, g_PendingMutex held.
+static void AdoptPendingLoad()
+{
+    PendingLoad& pl = g_PendingLoad;
+
+    int totalPois = 0, totalTrails = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_PacksMutex);
+
+        std::vector<TacoPack> loaded;
+        loaded.reserve(pl.packs.size());
+        for (size_t i = 0; i < pl.packs.size(); ++i)
+        {
+            if (pl.results[i] == PackResult::Loaded)
+                loaded.push_back(std::move(pl.packs[i]));
+            else if (pl.results[i] == PackResult::Unchanged)
+                loaded.push_back(std::move(g_Packs[pl.prevIndex[i]]));
+            else
+                continue;
+            totalPois   += (int)loaded.back().pois.size();
+            totalTrails += (int)loaded.back().trails.size();
+        }
         g_Packs = std::move(loaded);
     }
+    DropRetiredAtlasPages();
+    g_TexArchives.clear();
+    // Replaced pack files may read fine now.
+    for (SlotState& slot : g_SlotStates)
+        if (slot.state == TexState::Failed) { slot.state = TexState::Idle; slot.failures = 0; }
     g_TotalPois   = totalPois;
     g_TotalTrails = totalTrails;
+    ++g_Generation;
 
-    // Restore enabled/disabled state from disk after packs are loaded
-    PackManager::LoadCategoryState();
-
-    g_Loading = false;
+    pl = PendingLoad{};
 
     if (APIDefs)
     {
@@ -438,6 +823,88 @@ static void LoadThread()
     }
 }
 
+static void LoadThread()
+{
+    // Reload() requests that arrive while a load is running are folded into
+    // one more pass, so the last change on disk is never missed.
+    for (;;)
+    {
+        LoadAllPacks();
+
+        std::lock_guard<std::mutex> lock(g_ReloadMutex);
+        if (ShuttingDown() || !g_ReloadRequested.exchange(false))
+        {
+            g_Loading = false;
+            return;
+        }
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Packs folder watcher
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Name, size and last-write time of every .taco file — what the watcher
+// compares to decide whether anything relevant changed.
+static std::string PacksFolderSignature(const std::string& dir)
+{
+    std::string sig;
+    std::string pattern = dir + "\\*.taco";
+
+    WIN32_FIND_DATAA fd{};
+    HANDLE h = FindFirstFileA(pattern.c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE) return sig;
+
+    do {
+        sig += fd.cFileName;
+        sig += '|' + std::to_string(fd.nFileSizeLow) + '|' + std::to_string(fd.nFileSizeHigh)
+             + '|' + std::to_string(fd.ftLastWriteTime.dwLowDateTime)
+             + '|' + std::to_string(fd.ftLastWriteTime.dwHighDateTime) + '\n';
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+    return sig;
+}
+
+// Waits for change notifications on the packs folder and reloads once it has
+// been quiet for kWatchSettleMs (copying a pack in fires a burst of
+// notifications).  If notifications aren't available — e.g. on some network
+// shares — it polls the folder signature every kWatchPollMs instead.
+static void WatchThread(std::string dir)
+{
+    HANDLE change = FindFirstChangeNotificationA(dir.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    const bool polling = (change == INVALID_HANDLE_VALUE);
+    HANDLE     handles[2] = { g_WatchStop, change };
+
+    std::string lastSig = PacksFolderSignature(dir);
+    for (;;)
+    {
+        if (polling)
+        {
+            if (WaitForSingleObject(g_WatchStop, kWatchPollMs) == WAIT_OBJECT_0) break;
+        }
+        else
+        {
+            DWORD w = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            if (w != WAIT_OBJECT_0 + 1) break;
+
+            // Debounce: keep swallowing notifications until the folder settles.
+            do { FindNextChangeNotification(change); }
+            while ((w = WaitForMultipleObjects(2, handles, FALSE, kWatchSettleMs)) == WAIT_OBJECT_0 + 1);
+            if (w != WAIT_TIMEOUT) break;
+        }
+
+        if (!g_Settings.AutoReloadPacks) continue;
+
+        std::string sig = PacksFolderSignature(dir);
+        if (sig == lastSig) continue;
+        lastSig = std::move(sig);
+        PackManager::Reload();
+    }
+
+    if (!polling) FindCloseChangeNotification(change);
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Public API
 // ─────────────────────────────────────────────────────────────────────────────
@@ -447,12 +914,29 @@ void PackManager::Init()
     // Make sure the packs directory exists so users know where to drop files
     PacksDirStatic();
 
+    g_ShuttingDown = false;
     g_Loading = true;
     g_LoadThread = std::thread(LoadThread);
+
+    std::string packsDir = PacksDirStatic();
+    g_WatchStop = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (g_WatchStop && !packsDir.empty())
+        g_WatchThread = std::thread(WatchThread, packsDir);
 }
 
 void PackManager::Shutdown()
 {
+    {
+        std::lock_guard<std::mutex> lock(g_PendingMutex);
+        g_ShuttingDown = true;
+    }
+    g_PendingCv.notify_all();
+
+    if (g_WatchStop) SetEvent(g_WatchStop);
+    if (g_WatchThread.joinable())
+        g_WatchThread.join();
+    if (g_WatchStop) { CloseHandle(g_WatchStop); g_WatchStop = nullptr; }
+
     if (g_LoadThread.joinable())
         g_LoadThread.join();
     SaveCategoryState();
@@ -460,7 +944,11 @@ void PackManager::Shutdown()
 
 void PackManager::Reload()
 {
-    if (g_Loading) return;
+    std::lock_guard<std::mutex> lock(g_ReloadMutex);
+    if (ShuttingDown()) return;
+
+    // Already loading: the load thread does one more pass when it finishes.
+    if (g_Loading) { g_ReloadRequested = true; return; }
 
     if (g_LoadThread.joinable())
         g_LoadThread.join();
@@ -479,36 +967,47 @@ std::vector<TacoPack>& PackManager::GetPacksMutable()
     return g_Packs;
 }
 
-std::vector<const Poi*> PackManager::GetPoisForMap(uint32_t mapId)
+void PackManager::Update()
 {
-    std::vector<const Poi*> result;
-    std::lock_guard<std::mutex> lock(g_PacksMutex);
-    for (const auto& pack : g_Packs)
+    if (!g_PendingReady.load()) return;
+
     {
-        if (!pack.enabled) continue;
-        for (const auto& poi : pack.pois)
-        {
-            if (poi.mapId == mapId && pack.IsCategoryEnabled(poi.type))
-                result.push_back(&poi);
-        }
+        std::lock_guard<std::mutex> lock(g_PendingMutex);
+        if (!g_PendingReady.load()) return;
+        AdoptPendingLoad();
+        g_PendingReady = false;
     }
-    return result;
+    g_PendingCv.notify_all();
 }
 
-std::vector<const Trail*> PackManager::GetTrailsForMap(uint32_t mapId)
+uint64_t PackManager::Generation() { return g_Generation.load(); }
+
+void PackManager::SetPackEnabled(TacoPack& pack, bool enabled)
 {
-    std::vector<const Trail*> result;
     std::lock_guard<std::mutex> lock(g_PacksMutex);
-    for (const auto& pack : g_Packs)
+    pack.enabled = enabled;
+}
+
+void PackManager::SetCategoryEnabled(MarkerCategory& category, bool enabled)
+{
+    std::lock_guard<std::mutex> lock(g_PacksMutex);
+    category.enabled = enabled;
+}
+
+void PackManager::SetCategoryExpanded(MarkerCategory& category, bool expanded)
+{
+    std::lock_guard<std::mutex> lock(g_PacksMutex);
+    category.expanded = expanded;
+}
+
+void PackManager::OnCategoriesChanged(TacoPack& pack)
+{
     {
-        if (!pack.enabled) continue;
-        for (const auto& trail : pack.trails)
-        {
-            if (trail.mapId == mapId && pack.IsCategoryEnabled(trail.type))
-                result.push_back(&trail);
-        }
+        std::lock_guard<std::mutex> lock(g_PacksMutex);
+        pack.RefreshEnabledBits();
     }
-    return result;
+    ++g_Generation;
+    SaveCategoryState();
 }
 
 bool PackManager::IsLoading()   { return g_Loading.load(); }
@@ -519,27 +1018,260 @@ int  PackManager::TotalTrailCount() { return g_TotalTrails.load(); }
 std::string PackManager::AddonDataDir() { return AddonDataDirStatic(); }
 std::string PackManager::PacksDir()     { return PacksDirStatic(); }
 
-void PackManager::FlushPendingTextures()
+// Calls fn(slot) for every texture slot used by mapId's enabled markers and
+// trails (a slot may come up more than once).  Render thread only.
+template <typename Fn>
+static void ForEachMapTexture(uint32_t mapId, Fn&& fn)
+{
+    std::lock_guard<std::mutex> lock(g_PacksMutex);
+    for (const auto& pack : g_Packs)
+    {
+        if (!pack.enabled) continue;
+        const MapRange* range = pack.FindMap(mapId);
+        if (!range) continue;
+        for (uint32_t i = range->poiBegin; i < range->poiEnd; ++i)
+        {
+            const Poi& poi = pack.pois[i];
+            if (pack.IsCategoryEnabled(poi.category))
+                fn(pack.icons[poi.attrib].texSlot);
+        }
+        for (uint32_t i = range->trailBegin; i < range->trailEnd; ++i)
+        {
+            const Trail& trail = pack.trails[i];
+            if (pack.IsCategoryEnabled(trail.category))
+                fn(trail.texSlot);
+        }
+    }
+}
+
+// Updates texture demand for mapId: queues its slots that aren't resident or
+// on the way and drops queued slots of other maps.
+static void UpdateTextureDemand(uint32_t mapId, bool newVisit)
+{
+    if (newVisit) ++g_MapVisit;
+    const uint32_t visit = g_MapVisit;
+
+    ForEachMapTexture(mapId, [visit](uint32_t slot)
+    {
+        if (slot >= g_SlotStates.size()) return;
+        SlotState& st = g_SlotStates[slot];
+        st.lastVisit = visit;
+        if (st.state != TexState::Idle) return;
+        st.state = TexState::Queued;
+        g_TexQueue.push_back(slot);
+    });
+
+    // Whatever another map left in the queue goes back to idle; it is
+    // queued again if that map is entered again.
+    size_t kept = 0;
+    for (size_t i = g_TexQueueHead; i < g_TexQueue.size(); ++i)
+    {
+        uint32_t slot = g_TexQueue[i];
+        if (g_SlotStates[slot].lastVisit == visit) g_TexQueue[kept++] = slot;
+        else                                       g_SlotStates[slot].state = TexState::Idle;
+    }
+    g_TexQueue.resize(kept);
+    g_TexQueueHead = 0;
+
+    // Slots are handed out in pack load order, so slot order keeps each
+    // pack's textures together and its archive is mapped once per run.
+    std::sort(g_TexQueue.begin(), g_TexQueue.end());
+}
+
+// The open archive of packFile, mapping it on first use; nullptr if it
+// can't be opened (tried again on the next request).
+static const PackArchive* TexArchive(const std::string& packFile)
+{
+    auto it = g_TexArchives.find(packFile);
+    if (it != g_TexArchives.end()) return it->second.get();
+
+    auto archive = std::make_unique<PackArchive>();
+    if (!archive->Open(packFile)) return nullptr;
+    return g_TexArchives.emplace(packFile, std::move(archive)).first->second.get();
+}
+
+// A registration that didn't work out: back to Idle and queued again on the
+// next flush, or Failed after kTexMaxAttempts in a row.
+static void FailTexture(uint32_t slot)
+{
+    SlotState& st = g_SlotStates[slot];
+    st.state = ++st.failures < kTexMaxAttempts ? TexState::Idle : TexState::Failed;
+    if (st.state == TexState::Idle) g_DemandStale = true;
+}
+
+// Registers one slot's texture with the host.  bytes is scratch space kept
+// between calls.
+static void RegisterTexture(uint32_t slot, std::vector<uint8_t>& bytes)
+{
+    // An atlas page's PNG is moved out rather than copied while the loader
+    // may be adding slots, and put back below: a failed load is retried
+    // from it and FlushPendingTextures frees it once the host has its own.
+    std::string          texId, packFile, entry;
+    std::vector<uint8_t> image;
+    {
+        std::lock_guard<std::mutex> lock(g_PendingTexMutex);
+        TexSource& src = g_TexSources[slot];
+        texId    = src.texId;
+        packFile = src.packFile;
+        entry    = src.entry;
+        image.swap(src.image);
+    }
+
+    // Registered before (by an earlier visit, or a previous session of the
+    // addon).
+    SlotState& st = g_SlotStates[slot];
+    if (Texture_t* t = APIDefs->Textures_Get(texId.c_str()))
+    {
+        g_TexSlotResources[slot] = t->Resource;
+        st.state    = TexState::Resident;
+        st.failures = 0;
+    }
+    else
+    {
+        // Requested only once the host has the bytes: a slot left Requested
+        // without a load in flight would never be queued again.
+        const uint8_t* data = image.data();
+        size_t         size = image.size();
+        if (image.empty())
+        {
+            const PackArchive* archive = TexArchive(packFile);
+            if (archive && archive->Read(entry, bytes)) { data = bytes.data(); size = bytes.size(); }
+        }
+        if (size == 0)
+        {
+            FailTexture(slot);
+        }
+        else
+        {
+            APIDefs->Textures_LoadFromMemory(texId.c_str(), data, size, OnTextureLoaded);
+            st.state        = TexState::Requested;
+            st.requestFrame = g_TexFrame;
+            g_TexInFlight.push_back(slot);
+        }
+    }
+
+    if (!image.empty())
+    {
+        std::lock_guard<std::mutex> lock(g_PendingTexMutex);
+        TexSource& src = g_TexSources[slot];
+        if (src.image.empty() && !src.imageDropped) src.image.swap(image);
+    }
+}
+
+void PackManager::FlushPendingTextures(uint32_t mapId)
 {
     if (!APIDefs) return;
 
-    std::vector<PendingTex> batch;
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    std::vector<ReadyTex> ready;
     {
         std::lock_guard<std::mutex> lock(g_PendingTexMutex);
-        if (g_PendingTextures.empty()) return;
-        batch.swap(g_PendingTextures);
+        ready.swap(g_ReadyTextures);
+        g_TexSlotResources.resize(g_TexSlotIds.size(), nullptr);
+        // The host has its own copy of a loaded atlas page.
+        for (const auto& r : ready)
+            if (r.resource) std::vector<uint8_t>().swap(g_TexSources[r.slot].image);
     }
+    const bool newSlots = g_SlotStates.size() != g_TexSlotResources.size();
+    g_SlotStates.resize(g_TexSlotResources.size());
+    ++g_TexFrame;
 
-    // Deduplicate — many POIs share the same icon texture
-    std::sort(batch.begin(), batch.end(),
-        [](const PendingTex& a, const PendingTex& b){ return a.texId < b.texId; });
-    auto last = std::unique(batch.begin(), batch.end(),
-        [](const PendingTex& a, const PendingTex& b){ return a.texId == b.texId; });
-    batch.erase(last, batch.end());
+    for (const auto& r : ready)
+    {
+        SlotState& slot = g_SlotStates[r.slot];
+        if (!r.resource)
+        {
+            if (slot.state == TexState::Requested) FailTexture(r.slot);
+            continue;
+        }
+        g_TexSlotResources[r.slot] = r.resource;
+        slot.state    = TexState::Resident;
+        slot.failures = 0;
+    }
 
-    for (const auto& pt : batch)
+    // Loads the host never answered.  Slots that came back (or were failed
+    // above) just leave the list.
+    size_t inFlight = 0;
+    for (uint32_t slot : g_TexInFlight)
     {
-        if (!APIDefs->Textures_Get(pt.texId.c_str()))
-            APIDefs->Textures_LoadFromFile(pt.texId.c_str(), pt.absPath.c_str(), nullptr);
+        SlotState& st = g_SlotStates[slot];
+        if (st.state != TexState::Requested) continue;
+        if (g_TexFrame - st.requestFrame >= kTexRequestTimeout) FailTexture(slot);
+        else                                                    g_TexInFlight[inFlight++] = slot;
+    }
+    g_TexInFlight.resize(inFlight);
+
+    // A new map, or new slots / toggled categories on this one.  Map 0 (a
+    // loading screen) keeps the last map's demand.
+    const uint64_t gen = g_Generation.load();
+    if (mapId != 0 && (mapId != g_DemandMap || gen != g_DemandGen || newSlots || g_DemandStale))
+    {
+        const bool newVisit = mapId != g_DemandMap;
+        const bool wasIdle  = g_TexQueueHead == g_TexQueue.size();
+        g_DemandMap   = mapId;
+        g_DemandGen   = gen;
+        g_DemandStale = false;
+        UpdateTextureDemand(mapId, newVisit);
+
+        // The rate measures a burst from its first frame, not from
+        // whenever the last window happened to close.
+        if (wasIdle && g_TexQueueHead < g_TexQueue.size())
+        {
+            g_TexRateStart = start;
+            g_TexRateCount = 0;
+        }
+    }
+
+    // Always make progress, even with a zero budget.
+    const auto budget = std::chrono::duration<float, std::milli>(g_Settings.TextureBudgetMs);
+    std::vector<uint8_t> bytes;
+    size_t               done = 0;
+    while (g_TexQueueHead < g_TexQueue.size())
+    {
+        RegisterTexture(g_TexQueue[g_TexQueueHead++], bytes);
+        ++done;
+        if (Clock::now() - start >= budget) break;
+    }
+
+    if (g_TexQueueHead == g_TexQueue.size())
+    {
+        g_TexQueue.clear();
+        g_TexQueueHead = 0;
+        g_TexArchives.clear();
+    }
+
+    // Stats.
+    const Clock::time_point now = Clock::now();
+    TextureQueueStats& st = g_TexStats;
+    st.queued      = g_TexQueue.size() - g_TexQueueHead;
+    st.lastFrame   = done;
+    st.lastFrameMs = std::chrono::duration<float, std::milli>(now - start).count();
+    if (done || !ready.empty() || newSlots)
+    {
+        st.resident = (size_t)std::count_if(g_SlotStates.begin(), g_SlotStates.end(),
+            [](const SlotState& s){ return s.state == TexState::Resident; });
+        st.failed   = (size_t)std::count_if(g_SlotStates.begin(), g_SlotStates.end(),
+            [](const SlotState& s){ return s.state == TexState::Failed; });
+    }
+
+    g_TexRateCount += done;
+    const float window = std::chrono::duration<float>(now - g_TexRateStart).count();
+    if (window >= 1.f)
+    {
+        st.perSecond   = (float)g_TexRateCount / window;
+        g_TexRateCount = 0;
+        g_TexRateStart = now;
     }
 }
+
+const PackManager::TextureQueueStats& PackManager::GetTextureQueueStats() { return g_TexStats; }
+
+std::shared_ptr<const LoadProfile::Report> PackManager::LastLoadReport()
+{
+    std::lock_guard<std::mutex> lock(g_LoadReportMutex);
+    return g_LoadReport;
+}
+
+const std::vector<void*>& PackManager::TextureSlots() { return g_TexSlotResources; }
@@ -1,21 +1,26 @@
 #pragma once
 #include "TacoPack.h"
+#include "LoadProfile.h"
 #include <string>
 #include <vector>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <cstdint>
 
 // ─────────────────────────────────────────────────────────────────────────────
 // PackManager
 //
 // Responsibilities:
 //   •  Discover .taco files (and pack directories) under the Pathing addon dir
-//   •  Extract .taco archives to a per-pack temp directory
+//   •  Read .taco archives in memory (no extraction to disk)
 //   •  Parse the XML + trail binaries into TacoPack structs
-//   •  Register all pack textures with the Nexus texture API
+//   •  Register pack textures with the Nexus texture API as maps need them
 //   •  Expose the loaded packs and provide a fast per-map filtered view
 //   •  Persist per-category enable/disable state
-//   •  Run loading on a background thread to avoid hitching the game
+//   •  Run loading on a background work-stealing pool to avoid hitching the game
+//   •  Watch the packs folder and reload incrementally — unchanged packs and
+//      unchanged XML files inside a changed pack are reused
 // ─────────────────────────────────────────────────────────────────────────────
 namespace PackManager
 {
@@ -23,44 +28,106 @@ namespace PackManager
 // ── Lifecycle ─────────────────────────────────────────────────────────────────
 
 // Call once from AddonLoad (after APIDefs is set).
-// Begins background scan & load of all packs found under the addon directory.
+// Begins background scan & load of all packs found under the addon directory
+// and starts watching the packs folder.
 void Init();
 
-// Call from AddonUnload.  Waits for any in-flight background work to finish.
+// Call from AddonUnload.  Stops the watcher and waits for any in-flight
+// background work to finish.
 void Shutdown();
 
 // ── Pack access ───────────────────────────────────────────────────────────────
 
-// Returns all loaded packs (main-thread read; loading thread posts completed
-// packs under a lock).
+// Returns all loaded packs.  Render thread only — the loaded set is swapped
+// in by Update(), on the same thread, so no lock is needed to read it.
 const std::vector<TacoPack>& GetPacks();
 
-// Returns mutable access (used by UI to toggle enabled state).
+// Returns mutable access (used by UI to toggle enabled state).  Pack and
+// category flags are changed only through the setters below — the loader
+// copies them from another thread; after an enabled flag changes call
+// OnCategoriesChanged().
 std::vector<TacoPack>& GetPacksMutable();
+void SetPackEnabled(TacoPack& pack, bool enabled);
+void SetCategoryEnabled(MarkerCategory& category, bool enabled);
+void SetCategoryExpanded(MarkerCategory& category, bool expanded);
+
+// Counter that advances whenever the visible set may have changed: a reload
+// was adopted, or a pack / category was toggled.  FilterPoisForMap /
+// FilterTrailsForMap results over GetPacks() stay valid (and current) for as
+// long as it doesn't change.
+uint64_t Generation();
+
+// Call after the UI changes pack.enabled or a category's enabled flag:
+// rebuilds the pack's enable bitset, advances Generation() and saves state.
+void OnCategoriesChanged(TacoPack& pack);
 
 // ── Filtered data for the current map ────────────────────────────────────────
 
-// Returns pointers to all enabled POIs for the given map ID, sorted by
-// distance for front-to-back draw ordering.  The pointers are into the
-// TacoPack data and remain valid until next Reload().
-std::vector<const Poi*>   GetPoisForMap(uint32_t mapId);
-std::vector<const Trail*> GetTrailsForMap(uint32_t mapId);
+// A marker paired with its record in the owning pack's attribute table.
+struct PoiView   { const Poi*   poi;   const MarkerAttribs* attribs; const IconRef* icon; };
+struct TrailView { const Trail* trail; const MarkerAttribs* attribs; };
+
+// Fills out with the enabled POIs / trails of packs for the given map ID
+// (out is cleared first, its capacity reused).  The pointers are into the
+// TacoPack data; for GetPacks() they remain valid until Generation() changes.
+// Plain functions over the pack data (PackFilter.cpp), so they build without
+// the Nexus side of PackManager.
+void FilterPoisForMap(const std::vector<TacoPack>& packs, uint32_t mapId,
+                      std::vector<PoiView>& out);
+void FilterTrailsForMap(const std::vector<TacoPack>& packs, uint32_t mapId,
+                        std::vector<TrailView>& out);
 
 // ── Operations ────────────────────────────────────────────────────────────────
 
-// Reload all packs from disk (async).  Used after the user drops a new pack.
+// Reload packs from disk (async).  Used after the user drops a new pack, and
+// by the folder watcher.  Packs whose archive is unchanged are kept as they
+// are; in a changed pack only XML files with a new CRC32 are parsed again.
+// Called while a load is running, it queues one more pass.
 void Reload();
 
+// Per-pack, per-stage profile of the last finished load (also written to
+// load_profile.json in the addon directory), or null before the first one.
+// Any thread.
+std::shared_ptr<const LoadProfile::Report> LastLoadReport();
+
 // Return loading status for display in the UI.
 bool   IsLoading();
 int    LoadedPackCount();
 int    TotalPoiCount();
 int    TotalTrailCount();
 
+// Call once per frame from the RT_Render callback, before anything reads the
+// packs.  Swaps in the result of a finished background load.
+void   Update();
+
 // Call once per frame from the RT_Render callback (main thread).
-// Drains any pending texture-registration requests posted by the background
-// loader — Nexus texture API calls must be made on the render thread.
-void   FlushPendingTextures();
+// Registers textures on demand — Nexus texture API calls must be made on the
+// render thread.  Entering a map queues the textures its enabled markers and
+// trails use that aren't registered yet; once registered a texture stays, as
+// the host can't unload it.  The queue is drained for at most
+// g_Settings.TextureBudgetMs per call (always at least one texture), the
+// rest trickling in over later frames.  mapId 0 (loading screens) keeps the
+// previous map's demand.
+void   FlushPendingTextures(uint32_t mapId);
+
+// Texture registration, for the debug overlay.  Render thread only.
+struct TextureQueueStats
+{
+    size_t queued      = 0;     // current map's textures waiting for registration
+    size_t resident    = 0;     // slots holding a loaded texture
+    size_t failed      = 0;     // slots given up on until the next load
+    size_t lastFrame   = 0;     // registered by the last call
+    float  lastFrameMs = 0.f;   // time the last call took
+    float  perSecond   = 0.f;   // drain rate over the last second
+};
+const TextureQueueStats& GetTextureQueueStats();
+
+// Resource (D3D11 SRV) of every texture slot, null while the texture isn't
+// loaded (not needed yet, still queued, or failed) — index with
+// IconRef::texSlot / Trail::texSlot after a bounds check, as a slot assigned
+// by a running load may not be in the table yet.
+// Render thread only; updated by FlushPendingTextures.
+const std::vector<void*>& TextureSlots();
 
 // Returns the root addon data directory, e.g. "<GW2>/addons/Pathing/"
 std::string AddonDataDir();
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Platform
+//
+// The few OS services the platform-independent core (parser, archive, pack
+// cache, renderer core) needs.  Platform_Win32.cpp backs the addon;
+// Platform_Posix.cpp lets the same core build on Linux for pathing_bench.
+// Everything else that talks to Windows or Nexus stays in the addon-only
+// files (entry, Shared, Settings, PackManager, MarkerRenderer, UI).
+// ─────────────────────────────────────────────────────────────────────────────
+namespace Platform
+{
+
+// ASCII case-insensitive compare (strcmp-style result); the n form compares
+// at most n characters.
+int CompareNoCase(const char* a, const char* b);
+int CompareNoCase(const char* a, const char* b, size_t n);
+
+// Size and last-write time of a file.  The time's unit is the platform's
+// own; it is only ever compared with values from the same platform.
+bool FileStamp(const std::string& path, uint64_t& size, uint64_t& mtime);
+
+// Moves from over to, replacing to if it exists.
+bool ReplaceFile(const std::string& from, const std::string& to);
+
+// Read-only mapping of a whole file; see MappedFile.
+struct FileMapping
+{
+    const uint8_t* data   = nullptr;
+    size_t         size   = 0;
+    void*          file   = nullptr;   // platform handles
+    void*          handle = nullptr;
+};
+
+// False if the file is missing, empty or can't be mapped (m is left empty).
+bool MapFile(const std::string& path, FileMapping& m);
+void UnmapFile(FileMapping& m);
+
+// Private (committed) bytes of this process, 0 if unknown.
+uint64_t PrivateBytes();
+
+// Broken-down local time of t.
+std::tm LocalTime(std::time_t t);
+
+} // namespace Platform
@@ -0,0 +1,79 @@
+#include "Platform.h"
+
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+
+int Platform::CompareNoCase(const char* a, const char* b)           { return strcasecmp(a, b); }
+int Platform::CompareNoCase(const char* a, const char* b, size_t n) { return strncasecmp(a, b, n); }
+
+bool Platform::FileStamp(const std::string& path, uint64_t& size, uint64_t& mtime)
+{
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0) return false;
+
+    size  = (uint64_t)st.st_size;
+    mtime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+    return true;
+}
+
+bool Platform::ReplaceFile(const std::string& from, const std::string& to)
+{
+    return std::rename(from.c_str(), to.c_str()) == 0;   // atomic, replaces
+}
+
+// file holds the descriptor + 1, so a null handle means "none".
+bool Platform::MapFile(const std::string& path, FileMapping& m)
+{
+    UnmapFile(m);
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    m.data = static_cast<const uint8_t*>(data);
+    m.size = (size_t)st.st_size;
+    m.file = reinterpret_cast<void*>((intptr_t)fd + 1);
+    return true;
+}
+
+void Platform::UnmapFile(FileMapping& m)
+{
+    if (m.data) munmap(const_cast<uint8_t*>(m.data), m.size);
+    if (m.file) close((int)(reinterpret_cast<intptr_t>(m.file) - 1));
+    m = FileMapping{};
+}
+
+uint64_t Platform::PrivateBytes()
+{
+    // Resident pages (second field of statm); close enough for load peaks.
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long long pages = 0, resident = 0;
+    int n = fscanf(f, "%llu %llu", &pages, &resident);
+    fclose(f);
+    return n == 2 ? resident * (uint64_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+std::tm Platform::LocalTime(std::time_t t)
+{
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    return tm;
+}
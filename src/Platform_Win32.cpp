@@ -0,0 +1,75 @@
+#include "Platform.h"
+
+#include <windows.h>
+#include <psapi.h>
+#include <cstring>
+
+int Platform::CompareNoCase(const char* a, const char* b)           { return _stricmp(a, b); }
+int Platform::CompareNoCase(const char* a, const char* b, size_t n) { return _strnicmp(a, b, n); }
+
+bool Platform::FileStamp(const std::string& path, uint64_t& size, uint64_t& mtime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA fad{};
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &fad))
+        return false;
+
+    size  = ((uint64_t)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+    mtime = ((uint64_t)fad.ftLastWriteTime.dwHighDateTime << 32) |
+            fad.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+bool Platform::ReplaceFile(const std::string& from, const std::string& to)
+{
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+bool Platform::MapFile(const std::string& path, FileMapping& m)
+{
+    UnmapFile(m);
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m.file = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        UnmapFile(m);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { UnmapFile(m); return false; }
+    m.handle = mapping;
+
+    m.data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m.data) { UnmapFile(m); return false; }
+    m.size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void Platform::UnmapFile(FileMapping& m)
+{
+    if (m.data)   UnmapViewOfFile(m.data);
+    if (m.handle) CloseHandle(m.handle);
+    if (m.file)   CloseHandle(m.file);
+    m = FileMapping{};
+}
+
+uint64_t Platform::PrivateBytes()
+{
+    PROCESS_MEMORY_COUNTERS pmc{};
+    pmc.cb = sizeof(pmc);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return pmc.PagefileUsage;   // commit charge, i.e. private bytes
+}
+
+std::tm Platform::LocalTime(std::time_t t)
+{
+    std::tm tm{};
+    localtime_s(&tm, &t);
+    return tm;
+}
@@ -0,0 +1,118 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+using namespace Profiler;
+
+namespace
+{
+    float      g_Samples[kStageCount][kHistory] = {};
+    CullFunnel g_Funnels[kHistory];
+    uint64_t   g_Frames = 0;   // frames begun; the current one is g_Frames - 1
+
+    size_t Slot(uint64_t frame) { return (size_t)(frame % kHistory); }
+
+    // Completed frames still in history, oldest first: [first, g_Frames - 1).
+    uint64_t FirstFrame()
+    {
+        uint64_t completed = g_Frames ? g_Frames - 1 : 0;
+        return completed > kHistory - 1 ? completed - (kHistory - 1) : 0;
+    }
+}
+
+const char* Profiler::StageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::Frame:      return "Frame";
+    case Stage::Textures:   return "Textures";
+    case Stage::VisibleSet: return "VisibleSet";
+    case Stage::Cull:       return "Cull";
+    case Stage::Sort:       return "Sort";
+    case Stage::TrailCull:  return "TrailCull";
+    case Stage::Prep:       return "Prep";
+    case Stage::TrailGeo:   return "TrailGeo";
+    case Stage::MarkerGeo:  return "MarkerGeo";
+    case Stage::Submit:     return "Submit";
+    default:                return "?";
+    }
+}
+
+void Profiler::BeginFrame()
+{
+    const size_t slot = Slot(g_Frames++);
+    for (size_t s = 0; s < kStageCount; ++s)
+        g_Samples[s][slot] = 0.f;
+    g_Funnels[slot] = CullFunnel{};
+}
+
+void Profiler::Record(Stage stage, float ms)
+{
+    if (g_Frames == 0) return;
+    g_Samples[(size_t)stage][Slot(g_Frames - 1)] += ms;
+}
+
+void Profiler::SetFunnel(const CullFunnel& funnel)
+{
+    if (g_Frames == 0) return;
+    g_Funnels[Slot(g_Frames - 1)] = funnel;
+}
+
+const CullFunnel& Profiler::LastFunnel()
+{
+    static const CullFunnel kNone;
+    return g_Frames >= 2 ? g_Funnels[Slot(g_Frames - 2)] : kNone;
+}
+
+bool Profiler::Summarize(StageStats (&out)[kStageCount])
+{
+    const uint64_t first = FirstFrame();
+    const uint64_t end   = g_Frames ? g_Frames - 1 : 0;
+    const size_t   n     = (size_t)(end - first);
+    if (n == 0) return false;
+
+    // Nearest-rank percentiles.
+    auto rank = [n](float p) { return std::min(n - 1, (size_t)(p * (float)n)); };
+
+    static std::vector<float> values;
+    values.resize(n);
+    for (size_t s = 0; s < kStageCount; ++s)
+    {
+        for (uint64_t f = first; f < end; ++f)
+            values[(size_t)(f - first)] = g_Samples[s][Slot(f)];
+
+        StageStats& st = out[s];
+        std::sort(values.begin(), values.end());
+        st.p50 = values[rank(0.50f)];
+        st.p95 = values[rank(0.95f)];
+        st.p99 = values[rank(0.99f)];
+        st.max = values[n - 1];
+    }
+    return true;
+}
+
+bool Profiler::ExportCsv(const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+
+    file << "frame";
+    for (size_t s = 0; s < kStageCount; ++s)
+        file << ',' << StageName((Stage)s) << "_ms";
+    file << ",candidates,distance_culled,frustum_culled,alpha_culled,drawn\n";
+
+    const uint64_t end = g_Frames ? g_Frames - 1 : 0;
+    for (uint64_t f = FirstFrame(); f < end; ++f)
+    {
+        const size_t slot = Slot(f);
+        file << f;
+        for (size_t s = 0; s < kStageCount; ++s)
+            file << ',' << g_Samples[s][slot];
+        const CullFunnel& cf = g_Funnels[slot];
+        file << ',' << cf.candidates << ',' << cf.distanceCulled << ',' << cf.frustumCulled
+             << ',' << cf.alphaCulled << ',' << cf.drawn << '\n';
+    }
+    return (bool)file;
+}
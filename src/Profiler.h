@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Profiler
+//
+// Per-frame timings of the render hot path, for the debug overlay.
+//   •  Each stage gets one sample per frame (milliseconds, 0 if it didn't
+//      run) in a ring of the last kHistory frames; the marker culling funnel
+//      is kept alongside.
+//   •  Samples are written and read on the render thread only, so the rings
+//      need no locking.  Work done on the prep workers is timed there and
+//      recorded by the render thread once the workers are done.
+//   •  Summaries (p50 / p95 / p99 / max) are computed on request, and the
+//      whole history can be written out as CSV.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace Profiler
+{
+
+constexpr size_t kHistory = 1024;   // frames
+
+enum class Stage : uint8_t
+{
+    Frame,        // all of MarkerRenderer::Render
+    Textures,     // PackManager::FlushPendingTextures
+    VisibleSet,   // per-map filtering and the render block (rebuilds only)
+    Cull,         // spatial grid query
+    Sort,         // marker draw order
+    TrailCull,    // trail / chunk culling and LOD selection
+    Prep,         // geometry build, wall time
+    TrailGeo,     // trail geometry, summed over the prep tasks
+    MarkerGeo,    // marker geometry, summed over the prep tasks
+    Submit,       // copying geometry into the ImGui draw list
+    Count
+};
+constexpr size_t kStageCount = (size_t)Stage::Count;
+
+const char* StageName(Stage stage);
+
+// Where this frame's markers went.  Grid cells rejected as a whole count as
+// frustum-culled, as do markers that project off screen.
+struct CullFunnel
+{
+    uint32_t candidates     = 0;   // markers on the map
+    uint32_t distanceCulled = 0;   // beyond MaxRenderDist
+    uint32_t frustumCulled  = 0;
+    uint32_t alphaCulled    = 0;   // faded out or smaller than a pixel
+    uint32_t drawn          = 0;
+};
+
+struct StageStats
+{
+    float p50 = 0.f, p95 = 0.f, p99 = 0.f, max = 0.f;   // ms
+};
+
+// Starts a new frame: its samples start at 0.  Render thread only, as is
+// everything else here.
+void BeginFrame();
+
+void Record(Stage stage, float ms);           // adds to the frame's sample
+void SetFunnel(const CullFunnel& funnel);
+
+// Last completed frame's funnel.
+const CullFunnel& LastFunnel();
+
+// Stats of every stage over the frames in history; false if there are none.
+bool Summarize(StageStats (&out)[kStageCount]);
+
+// Writes the history, oldest frame first, to path.  False if the file can't
+// be written.
+bool ExportCsv(const std::string& path);
+
+// Records the time between construction and destruction.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Stage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer()
+    {
+        Record(stage, std::chrono::duration<float, std::milli>(
+                          std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage                                 stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace Profiler
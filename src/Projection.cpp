@@ -0,0 +1,244 @@
+#include "Projection.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define PATHING_PROJECT_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles intrinsics for any instruction set; GCC / Clang need the
+// function itself marked.
+#if defined(PATHING_PROJECT_X64) && (defined(__GNUC__) || defined(__clang__))
+#define PATHING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PATHING_TARGET_AVX2
+#endif
+
+using namespace Math;
+
+ProjectionParams ProjectionParams::Make(const Mat4& viewProj, const Vec3& camPos,
+                                        float screenW, float screenH, float fovY, float maxDist)
+{
+    ProjectionParams p;
+    p.viewProj = viewProj;
+    p.camPos   = camPos;
+    p.screenW  = screenW;
+    p.screenH  = screenH;
+    p.ppuScale = (screenH * 0.5f) / std::tan(fovY * 0.5f);
+    p.maxDist  = maxDist;
+    return p;
+}
+
+void PointBatch::Resize(size_t n)
+{
+    x.resize(n); y.resize(n); z.resize(n);
+    sx.resize(n); sy.resize(n);
+    dist.resize(n);
+    ppu.resize(n);
+    visible.resize(n);
+}
+
+// ── Scalar ────────────────────────────────────────────────────────────────────
+
+static void ProjectRange(const ProjectionParams& p, PointBatch& b, size_t begin, size_t end)
+{
+    const auto& m = p.viewProj.m;
+    for (size_t i = begin; i < end; ++i)
+    {
+        float x = b.x[i], y = b.y[i], z = b.z[i];
+        float cx = m[0][0]*x + m[1][0]*y + m[2][0]*z + m[3][0];
+        float cy = m[0][1]*x + m[1][1]*y + m[2][1]*z + m[3][1];
+        float cw = m[0][3]*x + m[1][3]*y + m[2][3]*z + m[3][3];
+
+        float dx = x - p.camPos.x, dy = y - p.camPos.y, dz = z - p.camPos.z;
+        float d  = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+        float ndcX = cx / cw;
+        float ndcY = cy / cw;
+        b.sx[i]   = (ndcX + 1.f) * 0.5f * p.screenW;
+        b.sy[i]   = (1.f - ndcY) * 0.5f * p.screenH;
+        b.dist[i] = d;
+        b.ppu[i]  = p.ppuScale / std::max(d, 0.1f);
+        b.visible[i] = cw > 0.f &&
+                       ndcX >= -p.ndcLimit && ndcX <= p.ndcLimit &&
+                       ndcY >= -p.ndcLimit && ndcY <= p.ndcLimit &&
+                       d <= p.maxDist;
+    }
+}
+
+#ifdef PATHING_PROJECT_X64
+
+// ── SSE2 (4 wide) ─────────────────────────────────────────────────────────────
+
+static size_t ProjectSse2(const ProjectionParams& p, PointBatch& b)
+{
+    const auto& m = p.viewProj.m;
+    const __m128 m00 = _mm_set1_ps(m[0][0]), m10 = _mm_set1_ps(m[1][0]),
+                 m20 = _mm_set1_ps(m[2][0]), m30 = _mm_set1_ps(m[3][0]);
+    const __m128 m01 = _mm_set1_ps(m[0][1]), m11 = _mm_set1_ps(m[1][1]),
+                 m21 = _mm_set1_ps(m[2][1]), m31 = _mm_set1_ps(m[3][1]);
+    const __m128 m03 = _mm_set1_ps(m[0][3]), m13 = _mm_set1_ps(m[1][3]),
+                 m23 = _mm_set1_ps(m[2][3]), m33 = _mm_set1_ps(m[3][3]);
+    const __m128 camX = _mm_set1_ps(p.camPos.x), camY = _mm_set1_ps(p.camPos.y),
+                 camZ = _mm_set1_ps(p.camPos.z);
+    const __m128 one  = _mm_set1_ps(1.f), half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps();
+    const __m128 minD = _mm_set1_ps(0.1f);
+    const __m128 sw   = _mm_set1_ps(p.screenW), sh = _mm_set1_ps(p.screenH);
+    const __m128 ppuS = _mm_set1_ps(p.ppuScale), maxD = _mm_set1_ps(p.maxDist);
+    const __m128 lim  = _mm_set1_ps(p.ndcLimit), nlim = _mm_set1_ps(-p.ndcLimit);
+
+    const size_t n = b.Size() & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&b.x[i]), y = _mm_loadu_ps(&b.y[i]), z = _mm_loadu_ps(&b.z[i]);
+
+        __m128 cx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)),
+                                          _mm_mul_ps(m20, z)), m30);
+        __m128 cy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)),
+                                          _mm_mul_ps(m21, z)), m31);
+        __m128 cw = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m03, x), _mm_mul_ps(m13, y)),
+                                          _mm_mul_ps(m23, z)), m33);
+
+        __m128 dx = _mm_sub_ps(x, camX), dy = _mm_sub_ps(y, camY), dz = _mm_sub_ps(z, camZ);
+        __m128 d  = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                           _mm_mul_ps(dz, dz)));
+
+        __m128 ndcX = _mm_div_ps(cx, cw);
+        __m128 ndcY = _mm_div_ps(cy, cw);
+        _mm_storeu_ps(&b.sx[i],   _mm_mul_ps(_mm_mul_ps(_mm_add_ps(ndcX, one), half), sw));
+        _mm_storeu_ps(&b.sy[i],   _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(one, ndcY), half), sh));
+        _mm_storeu_ps(&b.dist[i], d);
+        _mm_storeu_ps(&b.ppu[i],  _mm_div_ps(ppuS, _mm_max_ps(d, minD)));
+
+        __m128 vis = _mm_and_ps(_mm_cmpgt_ps(cw, zero), _mm_cmple_ps(d, maxD));
+        vis = _mm_and_ps(vis, _mm_and_ps(_mm_cmpge_ps(ndcX, nlim), _mm_cmple_ps(ndcX, lim)));
+        vis = _mm_and_ps(vis, _mm_and_ps(_mm_cmpge_ps(ndcY, nlim), _mm_cmple_ps(ndcY, lim)));
+        int mask = _mm_movemask_ps(vis);
+        for (int k = 0; k < 4; ++k) b.visible[i + k] = (uint8_t)((mask >> k) & 1);
+    }
+    return n;
+}
+
+// ── AVX2 (8 wide) ─────────────────────────────────────────────────────────────
+
+PATHING_TARGET_AVX2
+static size_t ProjectAvx2(const ProjectionParams& p, PointBatch& b)
+{
+    const auto& m = p.viewProj.m;
+    const __m256 m00 = _mm256_set1_ps(m[0][0]), m10 = _mm256_set1_ps(m[1][0]),
+                 m20 = _mm256_set1_ps(m[2][0]), m30 = _mm256_set1_ps(m[3][0]);
+    const __m256 m01 = _mm256_set1_ps(m[0][1]), m11 = _mm256_set1_ps(m[1][1]),
+                 m21 = _mm256_set1_ps(m[2][1]), m31 = _mm256_set1_ps(m[3][1]);
+    const __m256 m03 = _mm256_set1_ps(m[0][3]), m13 = _mm256_set1_ps(m[1][3]),
+                 m23 = _mm256_set1_ps(m[2][3]), m33 = _mm256_set1_ps(m[3][3]);
+    const __m256 camX = _mm256_set1_ps(p.camPos.x), camY = _mm256_set1_ps(p.camPos.y),
+                 camZ = _mm256_set1_ps(p.camPos.z);
+    const __m256 one  = _mm256_set1_ps(1.f), half = _mm256_set1_ps(0.5f),
+                 zero = _mm256_setzero_ps();
+    const __m256 minD = _mm256_set1_ps(0.1f);
+    const __m256 sw   = _mm256_set1_ps(p.screenW), sh = _mm256_set1_ps(p.screenH);
+    const __m256 ppuS = _mm256_set1_ps(p.ppuScale), maxD = _mm256_set1_ps(p.maxDist);
+    const __m256 lim  = _mm256_set1_ps(p.ndcLimit), nlim = _mm256_set1_ps(-p.ndcLimit);
+
+    const size_t n = b.Size() & ~size_t(7);
+    for (size_t i = 0; i < n; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(&b.x[i]), y = _mm256_loadu_ps(&b.y[i]),
+               z = _mm256_loadu_ps(&b.z[i]);
+
+        __m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, x),
+                                  _mm256_mul_ps(m10, y)), _mm256_mul_ps(m20, z)), m30);
+        __m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, x),
+                                  _mm256_mul_ps(m11, y)), _mm256_mul_ps(m21, z)), m31);
+        __m256 cw = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m03, x),
+                                  _mm256_mul_ps(m13, y)), _mm256_mul_ps(m23, z)), m33);
+
+        __m256 dx = _mm256_sub_ps(x, camX), dy = _mm256_sub_ps(y, camY),
+               dz = _mm256_sub_ps(z, camZ);
+        __m256 d  = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                   _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+
+        __m256 ndcX = _mm256_div_ps(cx, cw);
+        __m256 ndcY = _mm256_div_ps(cy, cw);
+        _mm256_storeu_ps(&b.sx[i],   _mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(ndcX, one), half), sw));
+        _mm256_storeu_ps(&b.sy[i],   _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(one, ndcY), half), sh));
+        _mm256_storeu_ps(&b.dist[i], d);
+        _mm256_storeu_ps(&b.ppu[i],  _mm256_div_ps(ppuS, _mm256_max_ps(d, minD)));
+
+        __m256 vis = _mm256_and_ps(_mm256_cmp_ps(cw, zero, _CMP_GT_OQ),
+                                   _mm256_cmp_ps(d, maxD, _CMP_LE_OQ));
+        vis = _mm256_and_ps(vis, _mm256_and_ps(_mm256_cmp_ps(ndcX, nlim, _CMP_GE_OQ),
+                                               _mm256_cmp_ps(ndcX, lim,  _CMP_LE_OQ)));
+        vis = _mm256_and_ps(vis, _mm256_and_ps(_mm256_cmp_ps(ndcY, nlim, _CMP_GE_OQ),
+                                               _mm256_cmp_ps(ndcY, lim,  _CMP_LE_OQ)));
+        int mask = _mm256_movemask_ps(vis);
+        for (int k = 0; k < 8; ++k) b.visible[i + k] = (uint8_t)((mask >> k) & 1);
+    }
+    return n;
+}
+
+static bool CpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const bool avx     = (r[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;   // OS saves YMM state
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // PATHING_PROJECT_X64
+
+// ── Dispatch ──────────────────────────────────────────────────────────────────
+
+namespace
+{
+    // Projects a multiple of the kernel's width from the front of the batch
+    // and returns how many points it did; the scalar path finishes the rest.
+    using Kernel = size_t (*)(const ProjectionParams&, PointBatch&);
+
+    struct KernelChoice { Kernel kernel; const char* name; };
+
+    KernelChoice ChooseKernel()
+    {
+#ifdef PATHING_PROJECT_X64
+        if (CpuHasAvx2()) return { ProjectAvx2, "avx2" };
+        return { ProjectSse2, "sse2" };   // baseline on x64
+#else
+        return { nullptr, "scalar" };
+#endif
+    }
+
+    const KernelChoice& Chosen()
+    {
+        static const KernelChoice choice = ChooseKernel();
+        return choice;
+    }
+}
+
+void Math::Project(const ProjectionParams& p, PointBatch& batch)
+{
+    const KernelChoice& k = Chosen();
+    size_t done = k.kernel ? k.kernel(p, batch) : 0;
+    ProjectRange(p, batch, done, batch.Size());
+}
+
+void Math::ProjectScalar(const ProjectionParams& p, PointBatch& batch)
+{
+    ProjectRange(p, batch, 0, batch.Size());
+}
+
+const char* Math::ProjectPathName() { return Chosen().name; }
@@ -0,0 +1,60 @@
+#pragma once
+#include "MathUtils.h"
+#include <vector>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Batched world-to-screen projection
+//
+// Projects arrays of world positions in one pass — 8 at a time with AVX2,
+// 4 with SSE2, one at a time otherwise (picked once, at first use, from what
+// the CPU supports).  Per point it produces the screen position, the camera
+// distance, the on-screen scale and a visibility flag, from camera constants
+// computed once per frame.
+//
+// Every path evaluates the same expressions in the same order as the scalar
+// one (no FMA), so results agree bit for bit; ProjectScalar is kept callable
+// as the reference.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace Math
+{
+
+// Per-frame camera constants shared by every batch.
+struct ProjectionParams
+{
+    Mat4  viewProj;
+    Vec3  camPos;
+    float screenW  = 0.f, screenH = 0.f;
+    float ppuScale = 0.f;    // pixels per world unit at distance 1: (screenH/2) / tan(fov/2)
+    float maxDist  = 0.f;    // points further away are not visible
+    float ndcLimit = 1.1f;   // same side margin as WorldToScreen / Frustum
+
+    static ProjectionParams Make(const Mat4& viewProj, const Vec3& camPos,
+                                 float screenW, float screenH, float fovY, float maxDist);
+};
+
+// Structure-of-arrays batch: fill x / y / z (via Resize), project, read the
+// rest.  Index i of every array is the same point.
+struct PointBatch
+{
+    std::vector<float>   x, y, z;       // input, world space
+    std::vector<float>   sx, sy;        // screen position (ImGui pixels)
+    std::vector<float>   dist;          // distance to camPos
+    std::vector<float>   ppu;           // ppuScale / max(dist, 0.1): pixels per world unit
+    std::vector<uint8_t> visible;       // 1: in front, inside ndcLimit and within maxDist
+
+    size_t Size() const { return x.size(); }
+    void   Resize(size_t n);
+};
+
+// visible[i] is set exactly for the points WorldToScreen accepts whose
+// distance is at most maxDist.  sx / sy / ppu are unspecified where it is 0.
+void Project(const ProjectionParams& p, PointBatch& batch);
+
+// One point at a time; the reference the vector paths must match.
+void ProjectScalar(const ProjectionParams& p, PointBatch& batch);
+
+// "avx2", "sse2" or "scalar" — the path Project() uses on this CPU.
+const char* ProjectPathName();
+
+} // namespace Math
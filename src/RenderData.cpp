@@ -0,0 +1,49 @@
+#include "RenderData.h"
+
+void PoiRenderBlock::Clear()
+{
+    x.clear(); y.clear(); z.clear();
+    iconSize.clear();
+    alpha.clear();
+    fadeNear.clear(); fadeFar.clear();
+    minSize.clear();  maxSize.clear();
+    color.clear();
+    texSlot.clear();
+    u0.clear(); v0.clear(); u1.clear(); v1.clear();
+}
+
+void PoiRenderBlock::Build(const std::vector<PackManager::PoiView>& pois)
+{
+    Clear();
+
+    const size_t n = pois.size();
+    x.reserve(n); y.reserve(n); z.reserve(n);
+    iconSize.reserve(n);
+    alpha.reserve(n);
+    fadeNear.reserve(n); fadeFar.reserve(n);
+    minSize.reserve(n);  maxSize.reserve(n);
+    color.reserve(n);
+    texSlot.reserve(n);
+    u0.reserve(n); v0.reserve(n); u1.reserve(n); v1.reserve(n);
+
+    for (const auto& view : pois)
+    {
+        const Poi*           poi = view.poi;
+        const MarkerAttribs& a   = *view.attribs;
+        x.push_back(poi->x);
+        y.push_back(poi->y + a.heightOffset);
+        z.push_back(poi->z);
+        iconSize.push_back(a.iconSize);
+        alpha.push_back(a.alpha);
+        fadeNear.push_back(a.fadeNear);
+        fadeFar.push_back(a.fadeFar);
+        minSize.push_back(a.minSize);
+        maxSize.push_back(a.maxSize);
+        color.push_back(a.color);
+
+        const IconRef& icon = *view.icon;
+        texSlot.push_back(icon.texSlot);
+        u0.push_back(icon.u0); v0.push_back(icon.v0);
+        u1.push_back(icon.u1); v1.push_back(icon.v1);
+    }
+}
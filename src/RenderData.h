@@ -0,0 +1,33 @@
+#pragma once
+#include "PackManager.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// PoiRenderBlock
+//
+// Structure-of-arrays copy of the per-marker data the marker draw loop reads,
+// for the POIs visible on one map.  Built next to the Poi objects whenever
+// the visible set changes; index i of every array is the same marker.
+//
+// A Poi carries type / guid strings and reaches its attributes through
+// the pack's shared table — an extra indirection per field, and most of the
+// bytes are never looked at while drawing.  The hot loop here streams only
+// positions, a handful of floats, a colour and a texture slot.
+// ─────────────────────────────────────────────────────────────────────────────
+struct PoiRenderBlock
+{
+    std::vector<float>    x, y, z;            // draw position (heightOffset applied)
+    std::vector<float>    iconSize;
+    std::vector<float>    alpha;
+    std::vector<float>    fadeNear, fadeFar;  // < 0 = use the global setting
+    std::vector<float>    minSize,  maxSize;  // < 0 = use the global setting
+    std::vector<uint32_t> color;              // ARGB
+    std::vector<uint32_t> texSlot;            // PackManager::TextureSlots index, or kNoTexSlot
+    std::vector<float>    u0, v0, u1, v1;     // icon rectangle within the texture
+
+    size_t Size() const { return x.size(); }
+    void   Clear();
+    void   Build(const std::vector<PackManager::PoiView>& pois);
+};
@@ -0,0 +1,634 @@
+#include "SceneRenderer.h"
+#include "Settings.h"
+#include "Projection.h"
+#include "SpatialGrid.h"
+#include "RenderData.h"
+#include "TaskPool.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+using namespace Math;
+
+static constexpr float  kNearClip      = 0.5f;    // world units
+static constexpr float  kFarClip       = 8000.f;  // world units (well beyond max render dist)
+static constexpr float  kDefaultIconSz = 32.f;    // screen pixels for iconSize=1.0
+static constexpr ImU32  kDefaultColor  = 0xFFFFFFFF;
+static constexpr float  kLodMaxErrorPx = 0.75f;   // max on-screen deviation of a trail LOD
+
+namespace
+{
+    // Visible entities of the current map.  Rebuilt only when the map, the
+    // pack generation or the marker / trail toggles change — on every other
+    // frame the lists (and the pointers in them) are reused as they are.
+    struct VisibleSet
+    {
+        bool     valid       = false;
+        uint32_t mapId       = 0;
+        uint64_t generation  = 0;
+        bool     showMarkers = false;
+        bool     showTrails  = false;
+
+        std::vector<PackManager::PoiView>   pois;
+        std::vector<PackManager::TrailView> trails;
+        PoiRenderBlock                      poiBlock;  // hot data of pois, same order
+        SpatialGrid                         poiGrid;   // over poiBlock positions
+    };
+    VisibleSet g_Visible;
+
+    // Per-frame scratch, kept to reuse its capacity.
+    struct DrawOrder { float distSq; uint32_t index; };
+    std::vector<uint32_t>  g_GridHits;
+
+    // Marker draw order, far to near.  Kept from frame to frame (until the
+    // visible set is rebuilt) so sorting only has to fix up what the camera
+    // movement changed.  g_HitFrame / g_HitDistSq are per poiBlock marker.
+    std::vector<DrawOrder> g_PoiOrder;
+    std::vector<uint32_t>  g_HitFrame;
+    std::vector<float>     g_HitDistSq;
+    uint32_t               g_OrderFrame = 0;
+
+    // A trail chunk that survived culling this frame, with its LOD level.
+    struct ChunkJob
+    {
+        const Trail*         trail;
+        const MarkerAttribs* attribs;
+        const TrailChunk*    chunk;
+        void*                texRes;
+        float                trailAlpha;
+        float                tileSize;
+        int                  level;
+    };
+    std::vector<ChunkJob>  g_ChunkJobs;
+
+    // Frame preparation.  Trail chunks and markers are split into tasks run
+    // on g_PrepPool (and on the render thread while it waits); each task
+    // builds into its own slot, and the slots are submitted in task order.
+    struct PrepSlot
+    {
+        GeoBuffer            geo;
+        PointBatch           pts;
+        float                ms = 0.f;   // time the task took
+        Profiler::CullFunnel funnel;     // marker tasks: projection and alpha culling
+    };
+    constexpr size_t kChunksPerTask  = 16;
+    constexpr size_t kMarkersPerTask = 512;
+    std::unique_ptr<TaskPool>              g_PrepPool;
+    std::vector<std::unique_ptr<PrepSlot>> g_PrepSlots;
+    std::vector<const GeoBuffer*>          g_SubmitLayer;
+}
+
+static void UpdateVisibleSet(const std::vector<TacoPack>& packs, uint32_t mapId, uint64_t gen)
+{
+    VisibleSet& vs = g_Visible;
+    if (vs.valid && vs.mapId == mapId && vs.generation == gen &&
+        vs.showMarkers == g_Settings.RenderMarkers && vs.showTrails == g_Settings.RenderTrails)
+        return;
+
+    Profiler::ScopedTimer timer(Profiler::Stage::VisibleSet);
+    vs.valid       = true;
+    vs.mapId       = mapId;
+    vs.generation  = gen;
+    vs.showMarkers = g_Settings.RenderMarkers;
+    vs.showTrails  = g_Settings.RenderTrails;
+
+    if (vs.showMarkers) PackManager::FilterPoisForMap(packs, mapId, vs.pois);
+    else                vs.pois.clear();
+
+    vs.poiBlock.Build(vs.pois);
+
+    std::vector<Vec3> positions(vs.poiBlock.Size());
+    for (size_t i = 0; i < positions.size(); ++i)
+        positions[i] = { vs.poiBlock.x[i], vs.poiBlock.y[i], vs.poiBlock.z[i] };
+    vs.poiGrid.Build(positions);
+
+    g_PoiOrder.clear();
+    g_HitFrame.assign(vs.poiBlock.Size(), 0);
+    g_HitDistSq.resize(vs.poiBlock.Size());
+
+    if (vs.showTrails)  PackManager::FilterTrailsForMap(packs, mapId, vs.trails);
+    else                vs.trails.clear();
+}
+
+Mat4 SceneRenderer::BuildViewProj(const Camera& cam, float screenW, float screenH)
+{
+    Vec3 camPos  = cam.position;
+    Vec3 f       = cam.front;
+    Vec3 topHint = cam.top;
+
+    f = f.Normalised();
+    Vec3 worldUp = (topHint.LengthSq() > 0.01f) ? topHint.Normalised()
+                                                  : Vec3{0.f, 1.f, 0.f};
+
+    Vec3 r = worldUp.Cross(f).Normalised();
+    Vec3 u = f.Cross(r).Normalised();
+    Mat4 view{};
+    view.m[0][0] = r.x; view.m[1][0] = r.y; view.m[2][0] = r.z; view.m[3][0] = -r.Dot(camPos);
+    view.m[0][1] = u.x; view.m[1][1] = u.y; view.m[2][1] = u.z; view.m[3][1] = -u.Dot(camPos);
+    view.m[0][2] = f.x; view.m[1][2] = f.y; view.m[2][2] = f.z; view.m[3][2] = -f.Dot(camPos);
+    view.m[3][3] = 1.f;
+
+    float fov    = cam.FovY();
+    float aspect = (screenH > 0.f) ? screenW / screenH : 1.7778f;
+    float tanHalfFov = std::tan(fov * 0.5f);
+
+    Mat4 proj{};
+    proj.m[0][0] = 1.f / (aspect * tanHalfFov);
+    proj.m[1][1] = 1.f / tanHalfFov;
+    proj.m[2][2] = kFarClip / (kFarClip - kNearClip);
+    proj.m[2][3] = 1.f;   // w_clip = z_view
+    proj.m[3][2] = -(kNearClip * kFarClip) / (kFarClip - kNearClip);
+
+    return proj * view;
+}
+
+static ImU32 ToImColor(uint32_t argb, float globalAlpha)
+{
+    uint8_t a = (uint8_t)((argb >> 24) & 0xFF);
+    uint8_t r = (uint8_t)((argb >> 16) & 0xFF);
+    uint8_t g = (uint8_t)((argb >>  8) & 0xFF);
+    uint8_t b = (uint8_t)( argb        & 0xFF);
+    a = (uint8_t)(a * globalAlpha);
+    return IM_COL32(r, g, b, a);
+}
+
+static float FadeAlpha(float dist, float fadeNear, float fadeFar,
+                       float globalFadeStart, float globalMaxDist)
+{
+    float distFar  = (fadeFar  >= 0.f) ? std::min(fadeFar,  globalMaxDist) : globalMaxDist;
+    float distNear = (fadeNear >= 0.f) ? std::min(fadeNear, distFar)       : std::min(globalFadeStart, distFar);
+    if (dist >= distFar  || distFar <= 0.f) return 0.f;
+    if (dist <= distNear || distFar <= distNear) return 1.f;
+    return 1.f - (dist - distNear) / (distFar - distNear);
+}
+
+// Builds the quads of count markers of block, listed far to near from order.
+// Adds the markers culled here, and those drawn, to funnel.
+static void BuildMarkers(GeoBuffer& geo, PointBatch& pts,
+                         const ProjectionParams& proj, const SolidTexture& solid,
+                         const std::vector<void*>& texSlots, const PoiRenderBlock& block,
+                         const DrawOrder* order, size_t count,
+                         Profiler::CullFunnel& funnel)
+{
+    pts.Resize(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+        const uint32_t i = order[k].index;
+        pts.x[k] = block.x[i]; pts.y[k] = block.y[i]; pts.z[k] = block.z[i];
+    }
+    Project(proj, pts);
+
+    for (size_t k = 0; k < count; ++k)
+    {
+        if (!pts.visible[k])
+        {
+            ++funnel.frustumCulled;
+            continue;
+        }
+
+        const uint32_t i    = order[k].index;
+        const float    dist = pts.dist[k];
+        const float    sx   = pts.sx[k], sy = pts.sy[k];
+
+        float halfSz = (kDefaultIconSz * block.iconSize[i] * g_Settings.MarkerScale
+                        * pts.ppu[k]) * 0.02f;
+
+        float minSz = (block.minSize[i] >= 0.f) ? block.minSize[i] : g_Settings.MinScreenSize;
+        float maxSz = (block.maxSize[i] >= 0.f) ? block.maxSize[i] : g_Settings.MaxScreenSize;
+        halfSz = std::clamp(halfSz, minSz * 0.5f, maxSz * 0.5f);
+
+        float fadeAlpha = FadeAlpha(dist,
+                                    block.fadeNear[i],
+                                    block.fadeFar[i],
+                                    g_Settings.FadeStartDist,
+                                    g_Settings.MaxRenderDist);
+        float alpha = block.alpha[i] * g_Settings.MarkerOpacity * fadeAlpha;
+
+        if (alpha < 0.01f || halfSz < 1.f)
+        {
+            ++funnel.alphaCulled;
+            continue;
+        }
+        ++funnel.drawn;
+
+        uint32_t slot   = block.texSlot[i];
+        void*    texRes = slot < texSlots.size() ? texSlots[slot] : nullptr;
+        if (texRes)
+        {
+            ImU32 tint = IM_COL32(255, 255, 255, (uint8_t)(alpha * 255.f));
+            const ImVec2 p[4]  = { { sx - halfSz, sy - halfSz }, { sx + halfSz, sy - halfSz },
+                                   { sx + halfSz, sy + halfSz }, { sx - halfSz, sy + halfSz } };
+            const ImVec2 uv[4] = { { block.u0[i], block.v0[i] }, { block.u1[i], block.v0[i] },
+                                   { block.u1[i], block.v1[i] }, { block.u0[i], block.v1[i] } };
+            geo.AddQuad((ImTextureID)texRes, p, uv, tint);
+        }
+        else
+        {
+            ImU32 fillCol   = ToImColor(block.color[i], alpha);
+            ImU32 borderCol = IM_COL32(255, 255, 255, (uint8_t)(alpha * 200.f));
+            geo.AddCircleFilled(solid, ImVec2(sx, sy), halfSz, fillCol, 16);
+            geo.AddCircle(      solid, ImVec2(sx, sy), halfSz, borderCol, 16, 1.5f);
+        }
+    }
+}
+
+static Aabb BoundsOf(const TrailPoint& lo, const TrailPoint& hi)
+{
+    Aabb b;
+    b.min = { lo.x, lo.y, lo.z };
+    b.max = { hi.x, hi.y, hi.z };
+    return b;
+}
+
+// Culls trails, then their chunks, and picks each surviving chunk's LOD
+// level.  Runs on the render thread; the chunks are built by BuildTrailChunk.
+static void CollectTrailChunks(const ProjectionParams& proj, const Frustum& frustum,
+                               const std::vector<void*>& texSlots,
+                               const std::vector<PackManager::TrailView>& trails,
+                               std::vector<ChunkJob>& jobs)
+{
+    const Vec3& camPos = proj.camPos;
+    float maxDistSq = g_Settings.MaxRenderDist * g_Settings.MaxRenderDist;
+
+    jobs.clear();
+    for (const auto& view : trails)
+    {
+        const Trail*         trail   = view.trail;
+        const MarkerAttribs& attribs = *view.attribs;
+        if (trail->points.empty()) continue;
+
+        // Whole trail first, then chunk by chunk — points are only touched in
+        // chunks that are near enough and at least partly in view.
+        Aabb trailBounds = BoundsOf(trail->boundsMin, trail->boundsMax);
+        if (trailBounds.DistSq(camPos) > maxDistSq || !frustum.Intersects(trailBounds))
+            continue;
+
+        float trailAlpha = attribs.alpha * g_Settings.TrailOpacity;
+        if (trailAlpha < 0.01f) continue;
+
+        void* texRes = trail->texSlot < texSlots.size() ? texSlots[trail->texSlot] : nullptr;
+        // tileSize in world units: one UV tile = one trail-diameter wide.
+        // Computed here so it's consistent between prevIdx and curIdx lookups.
+        float tileSize = g_Settings.TrailWidth * attribs.trailScale * 2.f;
+        if (tileSize < 0.001f) tileSize = 0.001f;
+
+        for (const TrailChunk& chunk : trail->chunks)
+        {
+            Aabb bounds = BoundsOf(chunk.boundsMin, chunk.boundsMax);
+            if (bounds.DistSq(camPos) > maxDistSq || !frustum.Intersects(bounds))
+                continue;
+
+            // Coarsest level whose simplification error, projected at the
+            // chunk's nearest point, stays under kLodMaxErrorPx.
+            float nearest = std::max(std::sqrt(bounds.DistSq(camPos)), 0.1f);
+            float ppuNear = proj.ppuScale / nearest;
+            int   level   = 0;
+            while (level + 1 < kTrailLodLevels &&
+                   kTrailLodTolerance[level + 1] * ppuNear <= kLodMaxErrorPx)
+                ++level;
+
+            jobs.push_back({ trail, &attribs, &chunk, texRes, trailAlpha, tileSize, level });
+        }
+    }
+}
+
+static void BuildTrailChunk(GeoBuffer& geo, PointBatch& pts,
+                            const ProjectionParams& proj, const SolidTexture& solid,
+                            const ChunkJob& job)
+{
+    const Trail*         trail   = job.trail;
+    const MarkerAttribs& attribs = *job.attribs;
+    const TrailChunk&    chunk   = *job.chunk;
+    const int            level   = job.level;
+
+    const uint32_t* lod   = level > 0 ? trail->lodIndices.data() + chunk.lodFirst[level - 1]
+                                      : nullptr;
+    const size_t    steps = level > 0 ? chunk.lodCount[level - 1] : chunk.count;
+
+    pts.Resize(steps);
+    for (size_t step = 0; step < steps; ++step)
+    {
+        const TrailPoint& tp = trail->points[lod ? lod[step] : chunk.first + step];
+        pts.x[step] = tp.x; pts.y[step] = tp.y; pts.z[step] = tp.z;
+    }
+    Project(proj, pts);
+
+    ImVec2 prevScreen{};
+    float  prevHalfW = 0.f;
+    float  prevA     = 1.f;
+    bool   hasPrev   = false;
+    size_t prevIdx   = 0;
+
+    for (size_t step = 0; step < steps; ++step)
+    {
+        const size_t ptIdx = lod ? lod[step] : chunk.first + step;
+        if (!pts.visible[step]) { hasPrev = false; continue; }
+
+        const float dist = pts.dist[step];
+        const float sx   = pts.sx[step], sy = pts.sy[step];
+
+        float halfW;
+        if (g_Settings.TrailPerspectiveScale)
+        {
+            halfW = g_Settings.TrailWidth * attribs.trailScale * pts.ppu[step];
+        }
+        else
+        {
+            halfW = g_Settings.TrailWidth * attribs.trailScale * 3.f;
+        }
+        halfW = std::max(halfW, 1.f);
+
+        float fadeA = FadeAlpha(dist,
+                                attribs.fadeNear,
+                                attribs.fadeFar,
+                                g_Settings.FadeStartDist,
+                                g_Settings.MaxRenderDist);
+        float pointA = job.trailAlpha * fadeA;
+
+        ImVec2 cur{ sx, sy };
+
+        if (hasPrev && pointA > 0.01f)
+        {
+            float dx = cur.x - prevScreen.x;
+            float dy = cur.y - prevScreen.y;
+            float len = std::sqrt(dx * dx + dy * dy);
+
+            if (len > 0.5f && len < proj.screenW * 0.5f)
+            {
+                float invLen = 1.f / len;
+                float px = -dy * invLen;
+                float py =  dx * invLen;
+
+                const ImVec2 p[4] = {
+                    { prevScreen.x + px * prevHalfW, prevScreen.y + py * prevHalfW },
+                    { cur.x        + px * halfW,     cur.y        + py * halfW     },
+                    { cur.x        - px * halfW,     cur.y        - py * halfW     },
+                    { prevScreen.x - px * prevHalfW, prevScreen.y - py * prevHalfW } };
+
+                float avgA = (prevA + pointA) * 0.5f;
+
+                // UV V-coords come directly from the precomputed arc length
+                // table.  These are anchored to world positions and are
+                // completely independent of camera, culling, or frame order.
+                float uvV     = trail->arcLengths[prevIdx] / job.tileSize;
+                float uvVNext = trail->arcLengths[ptIdx]   / job.tileSize;
+
+                if (job.texRes)
+                {
+                    ImU32 tint = IM_COL32(255, 255, 255, (uint8_t)(avgA * 255.f));
+                    const ImVec2 uv[4] = { { 0.f, uvVNext }, { 0.f, uvV },
+                                           { 1.f, uvV },     { 1.f, uvVNext } };
+                    geo.AddQuad((ImTextureID)job.texRes, p, uv, tint);
+                }
+                else
+                {
+                    geo.AddSolidQuad(solid, p, ToImColor(attribs.trailColor, avgA));
+                }
+            }
+        }
+
+        prevScreen = cur;
+        prevIdx    = ptIdx;
+        prevHalfW  = halfW;
+        prevA      = pointA;
+        hasPrev    = (pointA > 0.01f);
+    }
+}
+
+// Insertion sort, far to near.  Last frame's order is nearly sorted for this
+// frame's keys, so this costs about one pass; after a teleport-sized shuffle
+// it gives up and falls back to std::sort.
+static void SortFarToNear(std::vector<DrawOrder>& order)
+{
+    size_t budget = order.size() * 8 + 64;   // element moves
+    for (size_t i = 1; i < order.size(); ++i)
+    {
+        DrawOrder item = order[i];
+        size_t j = i;
+        for (; j > 0 && order[j - 1].distSq < item.distSq; --j)
+        {
+            order[j] = order[j - 1];
+            if (--budget == 0)
+            {
+                order[j - 1] = item;
+                std::sort(order.begin(), order.end(),
+                    [](const DrawOrder& a, const DrawOrder& b){ return a.distSq > b.distSq; });
+                return;
+            }
+        }
+        order[j] = item;
+    }
+}
+
+// Rebuilds order from this frame's grid hits within maxDistSq of the camera:
+// markers still visible keep last frame's position, new ones are appended,
+// and the result is re-sorted on fresh distances.  Returns the number of
+// grid hits beyond maxDistSq.
+static size_t UpdateDrawOrder(const PoiRenderBlock& block, const Vec3& cam, float maxDistSq,
+                              std::vector<DrawOrder>& order)
+{
+    if (++g_OrderFrame == 0)
+    {
+        std::fill(g_HitFrame.begin(), g_HitFrame.end(), 0u);
+        g_OrderFrame = 1;
+    }
+    const uint32_t frame = g_OrderFrame;
+
+    size_t tooFar = 0;
+    for (uint32_t i : g_GridHits)
+    {
+        float d = DistSq(cam, Vec3{ block.x[i], block.y[i], block.z[i] });
+        if (d > maxDistSq)
+        {
+            ++tooFar;
+            continue;
+        }
+        g_HitFrame[i]  = frame;
+        g_HitDistSq[i] = d;
+    }
+
+    // Survivors in last frame's order, then the newcomers.  Placed markers
+    // are unstamped so each is taken once.
+    size_t kept = 0;
+    for (const DrawOrder& item : order)
+    {
+        uint32_t i = item.index;
+        if (g_HitFrame[i] != frame) continue;
+        g_HitFrame[i]  = 0;
+        order[kept++] = { g_HitDistSq[i], i };
+    }
+    order.resize(kept);
+    for (uint32_t i : g_GridHits)
+    {
+        if (g_HitFrame[i] != frame) continue;
+        g_HitFrame[i] = 0;
+        order.push_back({ g_HitDistSq[i], i });
+    }
+
+    SortFarToNear(order);
+    return tooFar;
+}
+
+static unsigned PrepThreadCount()
+{
+    // Leave most cores to the game; the render thread helps while it waits.
+    unsigned hw = std::thread::hardware_concurrency();
+    return std::clamp(hw / 2, 1u, 4u);
+}
+
+// Builds this frame's trail and marker geometry into g_PrepSlots, one slot
+// per task, and returns once every task has finished.  Trail tasks come
+// first; returns how many there are.
+static size_t PrepareGeometry(const ProjectionParams& proj, const SceneRenderer::FrameInput& in,
+                              const PoiRenderBlock& block, const std::vector<DrawOrder>& order)
+{
+    const SolidTexture& solid = in.solid;
+
+    const std::vector<ChunkJob>& jobs = g_ChunkJobs;
+    const size_t trailTasks  = (jobs.size()  + kChunksPerTask  - 1) / kChunksPerTask;
+    const size_t markerTasks = (order.size() + kMarkersPerTask - 1) / kMarkersPerTask;
+    const size_t taskCount   = trailTasks + markerTasks;
+
+    while (g_PrepSlots.size() < taskCount)
+        g_PrepSlots.push_back(std::make_unique<PrepSlot>());
+    for (auto& slot : g_PrepSlots)
+    {
+        slot->geo.Clear();
+        slot->ms     = 0.f;
+        slot->funnel = Profiler::CullFunnel{};
+    }
+
+    auto runTask = [&](size_t t)
+    {
+        PrepSlot& slot = *g_PrepSlots[t];
+        const auto start = std::chrono::steady_clock::now();
+        if (t < trailTasks)
+        {
+            size_t begin = t * kChunksPerTask;
+            size_t end   = std::min(begin + kChunksPerTask, jobs.size());
+            for (size_t j = begin; j < end; ++j)
+                BuildTrailChunk(slot.geo, slot.pts, proj, solid, jobs[j]);
+        }
+        else
+        {
+            size_t begin = (t - trailTasks) * kMarkersPerTask;
+            size_t count = std::min(kMarkersPerTask, order.size() - begin);
+            BuildMarkers(slot.geo, slot.pts, proj, solid, *in.texSlots, block,
+                         order.data() + begin, count, slot.funnel);
+        }
+        slot.ms = std::chrono::duration<float, std::milli>(
+                      std::chrono::steady_clock::now() - start).count();
+    };
+
+    try
+    {
+        // Not worth waking a worker for a single task.
+        if (taskCount == 1)
+        {
+            runTask(0);
+        }
+        else if (taskCount > 1)
+        {
+            if (!g_PrepPool) g_PrepPool = std::make_unique<TaskPool>(PrepThreadCount());
+            TaskPool::TaskGroup group;
+            for (size_t t = 0; t < taskCount; ++t)
+                g_PrepPool->Submit(group, [&runTask, t]{ runTask(t); });
+            g_PrepPool->Wait(group);
+        }
+    }
+    catch (...)
+    {
+        // Out of memory mid-build: draw nothing rather than part of the
+        // scene, and try again next frame.
+        for (auto& slot : g_PrepSlots) slot->geo.Clear();
+    }
+    return trailTasks;
+}
+
+void SceneRenderer::Shutdown()
+{
+    g_PrepPool.reset();
+    g_PrepSlots.clear();
+}
+
+void SceneRenderer::Render(const FrameInput& in, ImDrawList* dl, FrameCounts* counts)
+{
+    if (in.screenW < 1.f || in.screenH < 1.f) return;
+
+    Mat4 vp  = BuildViewProj(in.camera, in.screenW, in.screenH);
+    Vec3 cam = in.camera.position;
+
+    UpdateVisibleSet(*in.packs, in.mapId, in.generation);
+    Frustum frustum = Frustum::FromViewProj(vp);
+    auto& trails = g_Visible.trails;
+    if (counts)
+    {
+        counts->pois   = g_Visible.pois.size();
+        counts->trails = trails.size();
+    }
+
+    // Only markers in grid cells within MaxRenderDist and the view frustum go
+    // on to the per-marker distance / projection tests.
+    SpatialGrid::QueryStats grid;
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::Cull);
+        g_GridHits.clear();
+        g_Visible.poiGrid.Query(cam, g_Settings.MaxRenderDist, frustum, g_GridHits, &grid);
+    }
+
+    const PoiRenderBlock& block = g_Visible.poiBlock;
+    auto& order = g_PoiOrder;
+    Profiler::CullFunnel funnel;
+    funnel.candidates     = (uint32_t)block.Size();
+    funnel.distanceCulled = (uint32_t)grid.distanceRejected;
+    funnel.frustumCulled  = (uint32_t)grid.frustumRejected;
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::Sort);
+        funnel.distanceCulled += (uint32_t)UpdateDrawOrder(
+            block, cam, g_Settings.MaxRenderDist * g_Settings.MaxRenderDist, order);
+    }
+
+    ProjectionParams proj = ProjectionParams::Make(vp, cam, in.screenW, in.screenH,
+                                                   in.camera.FovY(), g_Settings.MaxRenderDist);
+
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::TrailCull);
+        CollectTrailChunks(proj, frustum, *in.texSlots, trails, g_ChunkJobs);
+    }
+    size_t trailTasks;
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::Prep);
+        trailTasks = PrepareGeometry(proj, in, block, order);
+    }
+    for (size_t t = 0; t < g_PrepSlots.size(); ++t)
+    {
+        const PrepSlot& slot = *g_PrepSlots[t];
+        Profiler::Record(t < trailTasks ? Profiler::Stage::TrailGeo : Profiler::Stage::MarkerGeo,
+                         slot.ms);
+        funnel.frustumCulled += slot.funnel.frustumCulled;
+        funnel.alphaCulled   += slot.funnel.alphaCulled;
+        funnel.drawn         += slot.funnel.drawn;
+    }
+    Profiler::SetFunnel(funnel);
+
+    // Trails under markers.  Trails are grouped by texture; markers keep
+    // their far-to-near order across textures too, so they only merge
+    // neighbouring spans that share one.
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::Submit);
+        std::vector<const GeoBuffer*>& layer = g_SubmitLayer;
+        layer.clear();
+        for (size_t t = 0; t < trailTasks && t < g_PrepSlots.size(); ++t)
+            layer.push_back(&g_PrepSlots[t]->geo);
+        SubmitByTexture(dl, layer.data(), layer.size());
+
+        layer.clear();
+        for (size_t t = trailTasks; t < g_PrepSlots.size(); ++t)
+            layer.push_back(&g_PrepSlots[t]->geo);
+        SubmitInOrder(dl, layer.data(), layer.size());
+    }
+}
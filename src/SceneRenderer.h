@@ -0,0 +1,68 @@
+#pragma once
+#include "MathUtils.h"
+#include "FramePrep.h"
+#include "PackManager.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SceneRenderer
+//
+// The platform-independent part of marker / trail rendering: given the packs,
+// a camera and the screen size, it culls, projects and builds the frame's
+// geometry and copies it into an ImGui draw list.  It never touches Nexus or
+// MumbleLink — MarkerRenderer gathers those inputs in the addon, and
+// pathing_bench fakes them on Linux.
+//
+// Render thread only (one caller at a time); the geometry itself is built by
+// a small worker pool.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace SceneRenderer
+{
+
+constexpr float kDefaultFovY = 1.222f;   // ~70°, when the game doesn't report one
+
+struct Camera
+{
+    Math::Vec3 position;
+    Math::Vec3 front;
+    Math::Vec3 top;
+    float      fovY = 0.f;    // vertical, radians; 0 = unknown
+
+    float FovY() const { return fovY > 0.01f ? fovY : kDefaultFovY; }
+};
+
+struct FrameInput
+{
+    // Visible entities are rebuilt from packs only when mapId or generation
+    // (or the marker / trail toggles) change; packs must stay valid until then.
+    const std::vector<TacoPack>* packs      = nullptr;
+    uint64_t                     generation = 0;
+    uint32_t                     mapId      = 0;
+
+    Camera camera;
+    float  screenW = 0.f;
+    float  screenH = 0.f;
+
+    const std::vector<void*>* texSlots = nullptr;   // see PackManager::TextureSlots
+    SolidTexture              solid;                // font atlas white pixel
+};
+
+// Sizes of the current map's visible set, for the debug overlay.
+struct FrameCounts
+{
+    size_t pois   = 0;
+    size_t trails = 0;
+};
+
+Math::Mat4 BuildViewProj(const Camera& camera, float screenW, float screenH);
+
+// Draws one frame into dl.  Per-stage timings and the culling funnel go to
+// Profiler.
+void Render(const FrameInput& in, ImDrawList* dl, FrameCounts* counts = nullptr);
+
+// Stops the frame-preparation workers.
+void Shutdown();
+
+} // namespace SceneRenderer
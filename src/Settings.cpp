@@ -2,6 +2,7 @@
 #include "Shared.h"
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <fstream>
 #include <string>
 
@@ -43,14 +44,20 @@ void Settings::Load()
         MinScreenSize    = j.value("MinScreenSize",      MinScreenSize);
         MaxScreenSize    = j.value("MaxScreenSize",      MaxScreenSize);
         ShowDebugInfo    = j.value("ShowDebugInfo",      ShowDebugInfo);
+        TextureBudgetMs  = j.value("TextureBudgetMs",    TextureBudgetMs);
         AutoHideInCombat = j.value("AutoHideInCombat",   AutoHideInCombat);
         AutoHideOnMount  = j.value("AutoHideOnMount",    AutoHideOnMount);
+        AutoReloadPacks  = j.value("AutoReloadPacks",    AutoReloadPacks);
 
         // Sanity clamp: fade start must be strictly less than max dist so
         // there is always a visible fade zone.  Old saves with FadeStartDist
         // == MaxRenderDist produce an empty fade range → everything full alpha.
         if (FadeStartDist >= MaxRenderDist)
             FadeStartDist = MaxRenderDist * 0.5f;
+
+        // Keep a hand-edited budget within the slider's range: one texture a
+        // frame at best below it, visible frame stalls above it.
+        TextureBudgetMs = std::clamp(TextureBudgetMs, 0.5f, 8.f);
     }
     catch (...) { /* malformed JSON — keep defaults */ }
 }
@@ -75,8 +82,10 @@ void Settings::Save() const
     j["MinScreenSize"]    = MinScreenSize;
     j["MaxScreenSize"]    = MaxScreenSize;
     j["ShowDebugInfo"]    = ShowDebugInfo;
+    j["TextureBudgetMs"]  = TextureBudgetMs;
     j["AutoHideInCombat"] = AutoHideInCombat;
     j["AutoHideOnMount"]  = AutoHideOnMount;
+    j["AutoReloadPacks"]  = AutoReloadPacks;
 
     std::ofstream(path) << j.dump(4);
 }
@@ -22,10 +22,12 @@ struct Settings
     float MinScreenSize   = 8.f;    // px — don't render icons smaller than this
     float MaxScreenSize   = 64.f;   // px — clamp icon screen size to this
     bool  ShowDebugInfo   = false;  // overlay debug text (fps, marker counts)
+    float TextureBudgetMs = 2.f;    // ms per frame spent registering textures
 
     // ── Behaviour ─────────────────────────────────────────────────────────────
     bool  AutoHideInCombat = false; // future: hide when in combat
     bool  AutoHideOnMount  = false; // future: hide when mounted
+    bool  AutoReloadPacks  = true;  // reload packs when the packs folder changes
 
     void Load();
     void Save() const;
@@ -0,0 +1,96 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Math;
+
+void SpatialGrid::Clear()
+{
+    cellsX = cellsZ = 0;
+    cellStart.clear();
+    items.clear();
+    cellBounds.clear();
+}
+
+void SpatialGrid::Build(const std::vector<Vec3>& positions)
+{
+    Clear();
+    if (positions.empty()) return;
+
+    Aabb bounds;
+    for (const auto& p : positions) bounds.Add(p);
+
+    float extent = std::max(bounds.max.x - bounds.min.x, bounds.max.z - bounds.min.z);
+    cellSize = std::max(kMinCellSize, extent / (float)kMaxCellsPerAxis);
+    originX  = bounds.min.x;
+    originZ  = bounds.min.z;
+    cellsX   = std::min(kMaxCellsPerAxis, (int)((bounds.max.x - originX) / cellSize) + 1);
+    cellsZ   = std::min(kMaxCellsPerAxis, (int)((bounds.max.z - originZ) / cellSize) + 1);
+
+    const size_t cellCount = (size_t)cellsX * cellsZ;
+    auto cellOf = [&](const Vec3& p)
+    {
+        int cx = std::clamp((int)((p.x - originX) / cellSize), 0, cellsX - 1);
+        int cz = std::clamp((int)((p.z - originZ) / cellSize), 0, cellsZ - 1);
+        return (size_t)cz * cellsX + cx;
+    };
+
+    // Counting sort into cells.
+    std::vector<uint32_t> cellIndex(positions.size());
+    cellStart.assign(cellCount + 1, 0);
+    cellBounds.assign(cellCount, Aabb{});
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        size_t c = cellOf(positions[i]);
+        cellIndex[i] = (uint32_t)c;
+        ++cellStart[c + 1];
+        cellBounds[c].Add(positions[i]);
+    }
+    for (size_t c = 0; c < cellCount; ++c)
+        cellStart[c + 1] += cellStart[c];
+
+    items.resize(positions.size());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < positions.size(); ++i)
+        items[fill[cellIndex[i]]++] = (uint32_t)i;
+}
+
+void SpatialGrid::Query(const Vec3& center, float radius, const Frustum& frustum,
+                        std::vector<uint32_t>& out, QueryStats* stats) const
+{
+    // Every item counts as too far until its cell is reached.
+    QueryStats local{ items.size(), 0 };
+    QueryStats& st = stats ? *stats : local;
+    st = local;
+    if (cellsX == 0) return;
+
+    // Cells overlapping the sphere's X/Z footprint.
+    int x0 = std::max(0,          (int)std::floor((center.x - radius - originX) / cellSize));
+    int x1 = std::min(cellsX - 1, (int)std::floor((center.x + radius - originX) / cellSize));
+    int z0 = std::max(0,          (int)std::floor((center.z - radius - originZ) / cellSize));
+    int z1 = std::min(cellsZ - 1, (int)std::floor((center.z + radius - originZ) / cellSize));
+    if (x0 > x1 || z0 > z1) return;
+
+    const float radiusSq = radius * radius;
+    for (int cz = z0; cz <= z1; ++cz)
+    {
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            size_t c = (size_t)cz * cellsX + cx;
+            uint32_t begin = cellStart[c], end = cellStart[c + 1];
+            if (begin == end) continue;
+
+            const Aabb& b = cellBounds[c];
+            if (b.DistSq(center) > radiusSq) continue;
+            st.distanceRejected -= end - begin;
+            if (!frustum.Intersects(b))
+            {
+                st.frustumRejected += end - begin;
+                continue;
+            }
+
+            out.insert(out.end(), items.begin() + begin, items.begin() + end);
+        }
+    }
+}
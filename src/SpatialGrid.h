@@ -0,0 +1,54 @@
+#pragma once
+#include "MathUtils.h"
+#include <vector>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SpatialGrid
+//
+// Uniform grid over the horizontal (X/Z) plane of one map, used to find the
+// markers near the camera without touching the rest of the map.
+//   •  Items are bucketed into square columns; each column stores the tight
+//      3D bounding box of its items, so the vertical extent is still culled.
+//   •  Buckets are stored CSR-style: one flat item array plus per-cell
+//      offsets — two allocations, no per-cell vectors.
+//   •  The cell size adapts to the map's extent so the grid stays small
+//      (at most kMaxCellsPerAxis² cells).
+// Built once per visible-set change; queried every frame.
+// ─────────────────────────────────────────────────────────────────────────────
+class SpatialGrid
+{
+public:
+    // Rebuild over the given positions; item i of a query result refers to
+    // positions[i].
+    void Build(const std::vector<Math::Vec3>& positions);
+    void Clear();
+
+    // Items a query left out, by the test their cell failed.  Together with
+    // the items returned they add up to ItemCount().
+    struct QueryStats
+    {
+        size_t distanceRejected = 0;   // cell beyond radius (or outside the grid's reach)
+        size_t frustumRejected  = 0;   // cell within radius but outside frustum
+    };
+
+    // Appends (unordered) the index of every item in a cell whose bounds lie
+    // within radius of center and intersect frustum.  Items are not tested
+    // individually — the caller still does its exact per-item checks.
+    void Query(const Math::Vec3& center, float radius, const Math::Frustum& frustum,
+               std::vector<uint32_t>& out, QueryStats* stats = nullptr) const;
+
+    size_t ItemCount() const { return items.size(); }
+
+private:
+    static constexpr int   kMaxCellsPerAxis = 64;
+    static constexpr float kMinCellSize     = 32.f;
+
+    float originX  = 0.f, originZ = 0.f;
+    float cellSize = 1.f;
+    int   cellsX   = 0,   cellsZ  = 0;
+
+    std::vector<uint32_t>   cellStart;   // cellsX*cellsZ + 1 offsets into items
+    std::vector<uint32_t>   items;       // item indices grouped by cell
+    std::vector<Math::Aabb> cellBounds;
+};
@@ -55,8 +55,27 @@ struct MarkerAttribs
     std::string texture;
 
     void InheritFrom(const MarkerAttribs& parent);
+
+    bool   operator==(const MarkerAttribs& o) const;
+    bool   operator!=(const MarkerAttribs& o) const { return !(*this == o); }
+    size_t Hash() const;
+};
+
+// Texture slot of a marker with no icon / trail texture.
+constexpr uint32_t kNoTexSlot = 0xFFFFFFFFu;
+
+// Where an icon lives: a texture slot (see PackManager::TextureSlots) and
+// the UV rectangle inside it — an atlas page, or the whole texture for icons
+// kept standalone.
+struct IconRef
+{
+    uint32_t texSlot = kNoTexSlot;
+    float    u0 = 0.f, v0 = 0.f, u1 = 1.f, v1 = 1.f;
 };
 
+// Category index used by markers whose type path doesn't match any category.
+constexpr uint32_t kNoCategory = 0xFFFFFFFFu;
+
 struct MarkerCategory
 {
     std::string name;
@@ -66,6 +85,9 @@ struct MarkerCategory
     bool enabled = true;
     bool expanded = false;
 
+    // Depth-first pre-order position in the pack's tree (TacoPack::IndexCategories).
+    uint32_t index = kNoCategory;
+
     std::vector<MarkerCategory> children;
 
     MarkerCategory* Find(const std::string& path);
@@ -77,28 +99,76 @@ struct MarkerCategory
 struct Poi
 {
     uint32_t    mapId  = 0;
+    uint32_t    source = 0;   // index into TacoPack::sources
     float       x = 0.f, y = 0.f, z = 0.f;
     std::string type;
     std::string guid;
-    MarkerAttribs attribs;
-
-    std::string texId;
+    uint32_t    category = kNoCategory;   // deepest category matching type
+    uint32_t    attrib   = 0;             // index into TacoPack::attribs
 };
 
 struct TrailPoint { float x, y, z; };
 
+// Trail level of detail.  Level 0 is every point; level L keeps the points
+// Douglas-Peucker retains at kTrailLodTolerance[L] world units, which the
+// renderer picks when that deviation projects to under a pixel or so.
+constexpr int   kTrailLodLevels = 4;
+constexpr float kTrailLodTolerance[kTrailLodLevels] = { 0.f, 0.25f, 1.f, 4.f };
+
+// A run of consecutive trail points with its bounding box, so the renderer
+// can cull a whole stretch of trail with one test.  Neighbouring chunks share
+// their boundary point: chunk k covers points [first, first + count) and
+// every segment between them, and no segment belongs to two chunks.
+struct TrailChunk
+{
+    uint32_t   first = 0;
+    uint32_t   count = 0;
+    TrailPoint boundsMin{};
+    TrailPoint boundsMax{};
+
+    // Simplified levels 1.. as ranges of Trail::lodIndices.  The indices point
+    // into Trail::points (so arcLengths still apply) and always include the
+    // chunk's first and last point.
+    uint32_t   lodFirst[kTrailLodLevels - 1] = {};
+    uint32_t   lodCount[kTrailLodLevels - 1] = {};
+};
+
 struct Trail
 {
-    uint32_t    mapId = 0;
+    uint32_t    mapId  = 0;
+    uint32_t    source = 0;   // index into TacoPack::sources
     std::string type;
     std::string trailDataFile;
-    MarkerAttribs attribs;
+    uint32_t    category = kNoCategory;   // deepest category matching type
+    uint32_t    attrib   = 0;             // index into TacoPack::attribs
     std::vector<TrailPoint> points;
     // Cumulative world-space arc length from point 0 to point i.
     // arcLengths[0] == 0.  Populated once at load time so the renderer can
     // compute stable UVs without accumulating per-frame.
     std::vector<float> arcLengths;
-    std::string texId;
+    // Built once at load time (TacoParser::BuildTrailChunks); boundsMin/Max
+    // enclose the whole trail.
+    std::vector<TrailChunk> chunks;
+    std::vector<uint32_t>   lodIndices;
+    TrailPoint              boundsMin{};
+    TrailPoint              boundsMax{};
+    uint32_t                texSlot = kNoTexSlot;   // see PackManager::TextureSlots
+};
+
+// Contiguous POI / Trail ranges of one map inside a pack (see BuildMapIndex).
+struct MapRange
+{
+    uint32_t mapId      = 0;
+    uint32_t poiBegin   = 0, poiEnd   = 0;
+    uint32_t trailBegin = 0, trailEnd = 0;
+};
+
+// One XML file of a pack, remembered so a reload can tell what changed.
+struct PackSource
+{
+    std::string file;               // normalised archive entry name
+    uint32_t    crc32        = 0;   // from the ZIP central directory
+    uint64_t    categoryHash = 0;   // TacoParser::CategoryHash of the file
 };
 
 struct TacoPack
@@ -107,10 +177,61 @@ struct TacoPack
     std::string filePath;
     bool        enabled = true;
 
+    // Identity of the archive the pack was built from, used by incremental
+    // reload to skip unchanged packs and XML files.
+    uint64_t    archiveSize  = 0;
+    uint64_t    archiveMtime = 0;
+    uint64_t    contentHash  = 0;
+    std::vector<PackSource>                   sources;        // XML files, archive order
+    std::unordered_map<std::string, uint32_t> trailFileCrcs;  // .trl entry → CRC32
+
     std::vector<MarkerCategory> categories;
     std::vector<Poi>            pois;
     std::vector<Trail>          trails;
-    std::unordered_map<std::string, std::string> extractedFiles;
-    std::string ResolveFile(const std::string& packRelPath) const;
-    bool IsCategoryEnabled(const std::string& typePath) const;
+
+    // Distinct resolved attribute records, shared by every POI / Trail that
+    // resolves to the same values (nearly all markers of a category do).
+    std::vector<MarkerAttribs>  attribs;
+
+    const MarkerAttribs& AttribsOf(const Poi& poi)     const { return attribs[poi.attrib]; }
+    const MarkerAttribs& AttribsOf(const Trail& trail) const { return attribs[trail.attrib]; }
+
+    // Icon of each attribs record (parallel to attribs), set by the loader
+    // once the pack's icon atlas is built.
+    std::vector<IconRef>        icons;
+
+    // pois / trails are stored sorted by mapId (stable, so XML order is kept
+    // within a map); mapIndex has one entry per map, sorted by mapId.
+    std::vector<MapRange>       mapIndex;
+
+    // Effective enabled state per category index — the category's own flag
+    // and every ancestor's.  Rebuilt by RefreshEnabledBits() whenever a flag
+    // changes, so filtering a marker is a single bit test.
+    std::vector<uint64_t>       enabledBits;
+    uint32_t                    categoryCount = 0;
+
+    // Number the category tree depth-first and resolve every POI / Trail type
+    // path to its category.  Call once after categories / markers are final.
+    void IndexCategories();
+
+    // Deepest category matching the dotted type path (case-insensitive), or
+    // kNoCategory if even the first segment doesn't match.  A marker is
+    // hidden by the deepest category its path reaches.
+    uint32_t ResolveCategory(const std::string& typePath) const;
+
+    void RefreshEnabledBits();
+
+    // Sort pois / trails by map and rebuild mapIndex.  Call once after the
+    // marker lists are final; invalidates pointers into pois / trails.
+    void BuildMapIndex();
+
+    // Range of the given map, or nullptr if the pack has nothing on it.
+    const MapRange* FindMap(uint32_t mapId) const;
+
+    bool IsCategoryEnabled(uint32_t category) const
+    {
+        if (!enabled) return false;
+        if (category == kNoCategory) return true;
+        return (enabledBits[category >> 6] >> (category & 63)) & 1;
+    }
 };
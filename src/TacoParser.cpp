@@ -1,5 +1,6 @@
 #include "TacoParser.h"
 #include "TacoPack.h"
+#include "Platform.h"
 
 #include <pugixml.hpp>
 #include <algorithm>
@@ -7,6 +8,7 @@
 #include <fstream>
 #include <sstream>
 #include <cstring>
+#include <cmath>
 #include <charconv>
 
 void MarkerAttribs::InheritFrom(const MarkerAttribs& p)
@@ -27,12 +29,50 @@ void MarkerAttribs::InheritFrom(const MarkerAttribs& p)
     if (texture.empty()          && !p.texture.empty())       texture       = p.texture;
 }
 
+bool MarkerAttribs::operator==(const MarkerAttribs& o) const
+{
+    return iconSize     == o.iconSize     && alpha        == o.alpha        &&
+           color        == o.color        && heightOffset == o.heightOffset &&
+           fadeNear     == o.fadeNear     && fadeFar      == o.fadeFar      &&
+           minSize      == o.minSize      && maxSize      == o.maxSize      &&
+           behavior     == o.behavior     && canFade      == o.canFade      &&
+           autoTrigger  == o.autoTrigger  && triggerRange == o.triggerRange &&
+           resetLength  == o.resetLength  && trailColor   == o.trailColor   &&
+           trailScale   == o.trailScale   && animSpeedMult == o.animSpeedMult &&
+           iconFile     == o.iconFile     && texture      == o.texture;
+}
+
+size_t MarkerAttribs::Hash() const
+{
+    // FNV-1a over the raw field bytes, 64-bit
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* p, size_t n)
+    {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 0x100000001b3ull; }
+    };
+    mix(iconFile.data(), iconFile.size());
+    mix(texture.data(),  texture.size());
+    mix(&iconSize, sizeof(iconSize));   mix(&alpha, sizeof(alpha));
+    mix(&color, sizeof(color));         mix(&heightOffset, sizeof(heightOffset));
+    mix(&fadeNear, sizeof(fadeNear));   mix(&fadeFar, sizeof(fadeFar));
+    mix(&minSize, sizeof(minSize));     mix(&maxSize, sizeof(maxSize));
+    mix(&behavior, sizeof(behavior));   mix(&triggerRange, sizeof(triggerRange));
+    mix(&resetLength, sizeof(resetLength));
+    mix(&trailColor, sizeof(trailColor));
+    mix(&trailScale, sizeof(trailScale));
+    mix(&animSpeedMult, sizeof(animSpeedMult));
+    uint8_t flags = (canFade ? 1 : 0) | (autoTrigger ? 2 : 0);
+    mix(&flags, 1);
+    return (size_t)h;
+}
+
 static MarkerCategory* FindImpl(std::vector<MarkerCategory>& cats,
                                 const std::string& head, const std::string& tail)
 {
     for (auto& c : cats)
     {
-        if (_stricmp(c.name.c_str(), head.c_str()) == 0)
+        if (Platform::CompareNoCase(c.name.c_str(), head.c_str()) == 0)
         {
             if (tail.empty()) return &c;
             auto dot = tail.find('.');
@@ -61,7 +101,7 @@ static MarkerCategory* FindOrCreateImpl(std::vector<MarkerCategory>& cats,
 {
     for (auto& c : cats)
     {
-        if (_stricmp(c.name.c_str(), head.c_str()) == 0)
+        if (Platform::CompareNoCase(c.name.c_str(), head.c_str()) == 0)
         {
             if (tail.empty()) return &c;
             auto dot = tail.find('.');
@@ -90,38 +130,109 @@ MarkerCategory* MarkerCategory::FindOrCreate(const std::string& path)
     return FindOrCreateImpl(children, h, t);
 }
 
-std::string TacoPack::ResolveFile(const std::string& packRelPath) const
+static void IndexCategoriesImpl(std::vector<MarkerCategory>& cats, uint32_t& next)
+{
+    for (auto& c : cats)
+    {
+        c.index = next++;
+        IndexCategoriesImpl(c.children, next);
+    }
+}
+
+void TacoPack::IndexCategories()
 {
-    std::string key = TacoParser::NormalisePath(packRelPath);
-    auto it = extractedFiles.find(key);
-    return it != extractedFiles.end() ? it->second : std::string{};
+    uint32_t next = 0;
+    IndexCategoriesImpl(categories, next);
+    categoryCount = next;
+
+    for (auto& poi : pois)     poi.category   = ResolveCategory(poi.type);
+    for (auto& trail : trails) trail.category = ResolveCategory(trail.type);
+
+    RefreshEnabledBits();
 }
 
-static bool IsCategoryEnabledImpl(const std::vector<MarkerCategory>& cats,
-                                  const std::string& head, const std::string& tail)
+uint32_t TacoPack::ResolveCategory(const std::string& typePath) const
 {
-    for (const auto& c : cats)
+    const std::vector<MarkerCategory>* level = &categories;
+    uint32_t    found   = kNoCategory;
+    const char* segment = typePath.c_str();
+
+    while (*segment)
     {
-        if (_stricmp(c.name.c_str(), head.c_str()) == 0)
+        const char* dot = strchr(segment, '.');
+        size_t      len = dot ? (size_t)(dot - segment) : strlen(segment);
+
+        const MarkerCategory* match = nullptr;
+        for (const auto& c : *level)
         {
-            if (!c.enabled) return false;
-            if (tail.empty()) return true;
-            auto dot = tail.find('.');
-            std::string h = dot == std::string::npos ? tail : tail.substr(0, dot);
-            std::string t = dot == std::string::npos ? ""   : tail.substr(dot + 1);
-            return IsCategoryEnabledImpl(c.children, h, t);
+            if (c.name.size() == len && Platform::CompareNoCase(c.name.c_str(), segment, len) == 0)
+            {
+                match = &c;
+                break;
+            }
         }
+        if (!match) break;
+
+        found = match->index;
+        level = &match->children;
+        if (!dot) break;
+        segment = dot + 1;
     }
-    return true;
+    return found;
+}
+
+static void RefreshEnabledBitsImpl(const std::vector<MarkerCategory>& cats, bool parentEnabled,
+                                   std::vector<uint64_t>& bits)
+{
+    for (const auto& c : cats)
+    {
+        bool on = parentEnabled && c.enabled;
+        if (on && c.index != kNoCategory && (c.index >> 6) < bits.size())
+            bits[c.index >> 6] |= uint64_t(1) << (c.index & 63);
+        RefreshEnabledBitsImpl(c.children, on, bits);
+    }
+}
+
+void TacoPack::RefreshEnabledBits()
+{
+    enabledBits.assign((categoryCount + 63) / 64, 0);
+    RefreshEnabledBitsImpl(categories, true, enabledBits);
 }
 
-bool TacoPack::IsCategoryEnabled(const std::string& typePath) const
+void TacoPack::BuildMapIndex()
 {
-    if (!enabled) return false;
-    auto dot = typePath.find('.');
-    std::string h = dot == std::string::npos ? typePath : typePath.substr(0, dot);
-    std::string t = dot == std::string::npos ? ""       : typePath.substr(dot + 1);
-    return IsCategoryEnabledImpl(categories, h, t);
+    auto byMap = [](const auto& a, const auto& b){ return a.mapId < b.mapId; };
+    if (!std::is_sorted(pois.begin(), pois.end(), byMap))
+        std::stable_sort(pois.begin(), pois.end(), byMap);
+    if (!std::is_sorted(trails.begin(), trails.end(), byMap))
+        std::stable_sort(trails.begin(), trails.end(), byMap);
+
+    // Merge the two sorted runs into one range per distinct map.
+    mapIndex.clear();
+    size_t p = 0, t = 0;
+    while (p < pois.size() || t < trails.size())
+    {
+        uint32_t mapId = UINT32_MAX;
+        if (p < pois.size())   mapId = std::min(mapId, pois[p].mapId);
+        if (t < trails.size()) mapId = std::min(mapId, trails[t].mapId);
+
+        MapRange r;
+        r.mapId    = mapId;
+        r.poiBegin = (uint32_t)p;
+        while (p < pois.size() && pois[p].mapId == mapId) ++p;
+        r.poiEnd     = (uint32_t)p;
+        r.trailBegin = (uint32_t)t;
+        while (t < trails.size() && trails[t].mapId == mapId) ++t;
+        r.trailEnd   = (uint32_t)t;
+        mapIndex.push_back(r);
+    }
+}
+
+const MapRange* TacoPack::FindMap(uint32_t mapId) const
+{
+    auto it = std::lower_bound(mapIndex.begin(), mapIndex.end(), mapId,
+        [](const MapRange& r, uint32_t id){ return r.mapId < id; });
+    return (it != mapIndex.end() && it->mapId == mapId) ? &*it : nullptr;
 }
 
 namespace TacoParser
@@ -217,7 +328,7 @@ static void BuildCategoryTree(const pugi::xml_node& xmlNode,
 
         MarkerCategory* existing = nullptr;
         for (auto& s : siblings)
-            if (_stricmp(s.name.c_str(), name.c_str()) == 0) { existing = &s; break; }
+            if (Platform::CompareNoCase(s.name.c_str(), name.c_str()) == 0) { existing = &s; break; }
 
         if (!existing)
         {
@@ -263,7 +374,7 @@ static MarkerAttribs ResolveTypeAttribs(const std::vector<MarkerCategory>& cats,
         const MarkerCategory* found = nullptr;
         for (const auto& c : *level)
         {
-            if (_stricmp(c.name.c_str(), seg.c_str()) == 0) { found = &c; break; }
+            if (Platform::CompareNoCase(c.name.c_str(), seg.c_str()) == 0) { found = &c; break; }
         }
         if (!found) break;
         result.InheritFrom(found->attribs);
@@ -272,7 +383,48 @@ static MarkerAttribs ResolveTypeAttribs(const std::vector<MarkerCategory>& cats,
     return result;
 }
 
-static void ParsePois(const pugi::xml_node& poisNode, TacoPack& out,
+// Pass-2 state for one document: type paths already resolved against the
+// category tree, and the interner the resolved records go into.
+struct PoiParseContext
+{
+    // A type's inherited attributes.  The record is only interned once a
+    // node uses it unchanged, so a type whose nodes all override something
+    // adds nothing to the table for itself.
+    struct TypeAttribs
+    {
+        MarkerAttribs base;
+        uint32_t      index = kNotInterned;
+    };
+    static constexpr uint32_t kNotInterned = 0xFFFFFFFFu;
+
+    const std::vector<MarkerCategory>&           categories;
+    TacoParser::AttribInterner&                  interner;
+    std::unordered_map<std::string, TypeAttribs> typeAttribs;
+
+    // The node's attributes: its type's inherited ones plus its own overrides.
+    // A node whose overrides change nothing shares its type's record.
+    uint32_t Resolve(const pugi::xml_node& n, const std::string& type)
+    {
+        auto it = typeAttribs.find(type);
+        if (it == typeAttribs.end())
+        {
+            TypeAttribs t;
+            if (!type.empty()) t.base = ResolveTypeAttribs(categories, type);
+            it = typeAttribs.emplace(type, std::move(t)).first;
+        }
+        TypeAttribs& t = it->second;
+
+        MarkerAttribs a = t.base;
+        ReadAttribs(n, a);
+        if (!(a == t.base)) return interner.Intern(a);
+
+        if (t.index == kNotInterned) t.index = interner.Intern(t.base);
+        return t.index;
+    }
+};
+
+static void ParsePois(const pugi::xml_node& poisNode, PoiParseContext& ctx,
+                      std::vector<Poi>& pois, std::vector<Trail>& trails,
                       TacoParser::TrailLoadStats* stats = nullptr)
 {
     for (const pugi::xml_node& n : poisNode.children("POI"))
@@ -288,11 +440,9 @@ static void ParsePois(const pugi::xml_node& poisNode, TacoPack& out,
         poi.type  = AttrStr(n, "type");
         poi.guid  = AttrStr(n, "GUID");
 
-        poi.attribs = poi.type.empty() ? MarkerAttribs{}
-                                       : ResolveTypeAttribs(out.categories, poi.type);
-        ReadAttribs(n, poi.attribs);
+        poi.attrib = ctx.Resolve(n, poi.type);
 
-        out.pois.push_back(std::move(poi));
+        pois.push_back(std::move(poi));
     }
 
     for (const pugi::xml_node& n : poisNode.children("Trail"))
@@ -309,59 +459,10 @@ static void ParsePois(const pugi::xml_node& poisNode, TacoPack& out,
             continue;
         }
 
-        trail.attribs = trail.type.empty() ? MarkerAttribs{}
-                                            : ResolveTypeAttribs(out.categories, trail.type);
-        ReadAttribs(n, trail.attribs);
+        trail.attrib = ctx.Resolve(n, trail.type);
+        trail.mapId = AttrUInt(n, "MapID", 0);
 
-        std::string absPath = out.ResolveFile(trail.trailDataFile);
-        if (absPath.empty())
-        {
-            if (stats)
-            {
-                ++stats->fileNotFound;
-                if (stats->sampleMissingPath.empty())
-                    stats->sampleMissingPath = trail.trailDataFile;
-            }
-            continue;
-        }
-
-        if (!LoadTrailBinary(absPath, trail))
-        {
-            if (stats) ++stats->binaryFailed;
-            continue;
-        }
-
-        uint32_t xmlMapId = AttrUInt(n, "MapID", 0);
-        if (xmlMapId != 0) trail.mapId = xmlMapId;
-
-        if (trail.mapId == 0)
-        {
-            if (stats) ++stats->noMapId;
-            continue;
-        }
-        if (trail.points.empty())
-        {
-            if (stats) ++stats->noPoints;
-            continue;
-        }
-
-        // Precompute cumulative arc lengths so the renderer can look up stable
-        // world-anchored UV coordinates without per-frame accumulation.
-        {
-            const auto& pts = trail.points;
-            trail.arcLengths.resize(pts.size(), 0.f);
-            for (size_t i = 1; i < pts.size(); ++i)
-            {
-                float dx = pts[i].x - pts[i-1].x;
-                float dy = pts[i].y - pts[i-1].y;
-                float dz = pts[i].z - pts[i-1].z;
-                trail.arcLengths[i] = trail.arcLengths[i-1] +
-                                      std::sqrt(dx*dx + dy*dy + dz*dz);
-            }
-        }
-
-        if (stats) ++stats->loaded;
-        out.trails.push_back(std::move(trail));
+        trails.push_back(std::move(trail));
     }
 }
 
@@ -372,36 +473,142 @@ static pugi::xml_node GetOverlayRoot(const pugi::xml_document& doc)
     return root;
 }
 
-void ParseXmlCategories(const std::string& xmlContent, TacoPack& out)
+XmlDocument::XmlDocument() = default;
+XmlDocument::~XmlDocument() = default;
+XmlDocument::XmlDocument(XmlDocument&&) noexcept = default;
+XmlDocument& XmlDocument::operator=(XmlDocument&&) noexcept = default;
+
+bool LoadXmlDocument(const std::string& xmlContent, XmlDocument& out)
+{
+    out.buffer.clear();
+    out.doc    = std::make_unique<pugi::xml_document>();
+    out.loaded = (bool)out.doc->load_buffer(xmlContent.data(), xmlContent.size());
+    if (!out.loaded) out.doc.reset();
+    return out.loaded;
+}
+
+bool LoadXmlDocument(std::vector<uint8_t>&& buffer, XmlDocument& out)
+{
+    out.buffer = std::move(buffer);
+    out.doc    = std::make_unique<pugi::xml_document>();
+    out.loaded = (bool)out.doc->load_buffer_inplace(out.buffer.data(), out.buffer.size());
+    if (!out.loaded)
+    {
+        out.doc.reset();
+        out.buffer.clear();
+    }
+    return out.loaded;
+}
+
+void ParseDocumentCategories(const XmlDocument& doc, TacoPack& out)
 {
-    pugi::xml_document doc;
-    if (!doc.load_string(xmlContent.c_str())) return;
-    pugi::xml_node root = GetOverlayRoot(doc);
+    if (!doc.loaded) return;
+    pugi::xml_node root = GetOverlayRoot(*doc.doc);
     if (!root) return;
     MarkerAttribs defaultAttribs;
     BuildCategoryTree(root, out.categories, defaultAttribs);
 }
 
-void ParseXmlPois(const std::string& xmlContent, TacoPack& out,
-                  TrailLoadStats* stats)
+static void HashCategoryNodes(const pugi::xml_node& xmlNode, uint64_t& h, bool& any)
 {
-    pugi::xml_document doc;
-    if (!doc.load_string(xmlContent.c_str())) return;
-    pugi::xml_node root = GetOverlayRoot(doc);
+    auto mix = [&h](const char* str)
+    {
+        for (const char* c = str; *c; ++c) { h ^= (uint8_t)*c; h *= 0x100000001b3ull; }
+        h ^= 0xFF; h *= 0x100000001b3ull;   // terminator, so "ab"+"c" != "a"+"bc"
+    };
+
+    for (const pugi::xml_node& child : xmlNode.children("MarkerCategory"))
+    {
+        any = true;
+        mix("<");
+        for (const pugi::xml_attribute& a : child.attributes())
+        {
+            mix(a.name());
+            mix(a.value());
+        }
+        HashCategoryNodes(child, h, any);
+        mix(">");
+    }
+}
+
+uint64_t CategoryHash(const XmlDocument& doc)
+{
+    if (!doc.loaded) return 0;
+    pugi::xml_node root = GetOverlayRoot(*doc.doc);
+    if (!root) return 0;
+
+    uint64_t h   = 0xcbf29ce484222325ull;   // FNV-1a, 64-bit
+    bool     any = false;
+    HashCategoryNodes(root, h, any);
+    return any ? (h ? h : 1) : 0;
+}
+
+void ParseDocumentPois(const XmlDocument& doc,
+                       const std::vector<MarkerCategory>& categories,
+                       std::vector<Poi>& pois, std::vector<Trail>& trails,
+                       std::vector<MarkerAttribs>& attribs,
+                       TrailLoadStats* stats)
+{
+    if (!doc.loaded) return;
+    pugi::xml_node root = GetOverlayRoot(*doc.doc);
     if (!root) return;
 
+    AttribInterner  interner(attribs);
+    PoiParseContext ctx{ categories, interner, {} };
+
     for (const pugi::xml_node& child : root.children())
     {
         if (std::string(child.name()) == "POIs")
-            ParsePois(child, out, stats);
+            ParsePois(child, ctx, pois, trails, stats);
     }
-    ParsePois(root, out, stats);
+    ParsePois(root, ctx, pois, trails, stats);
+}
+
+void ParseDocumentPois(const XmlDocument& doc, TacoPack& out,
+                       TrailLoadStats* stats)
+{
+    ParseDocumentPois(doc, out.categories, out.pois, out.trails, out.attribs, stats);
+}
+
+AttribInterner::AttribInterner(std::vector<MarkerAttribs>& table)
+    : table(table)
+{
+    byHash.reserve(table.size());
+    for (size_t i = 0; i < table.size(); ++i)
+        byHash.emplace(table[i].Hash(), (uint32_t)i);
+}
+
+uint32_t AttribInterner::Intern(const MarkerAttribs& a)
+{
+    size_t h = a.Hash();
+    auto range = byHash.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it)
+        if (table[it->second] == a) return it->second;
+
+    uint32_t index = (uint32_t)table.size();
+    table.push_back(a);
+    byHash.emplace(h, index);
+    return index;
+}
+
+void TrailLoadStats::Merge(const TrailLoadStats& o)
+{
+    xmlTrailNodes += o.xmlTrailNodes;
+    noDataAttr    += o.noDataAttr;
+    fileNotFound  += o.fileNotFound;
+    binaryFailed  += o.binaryFailed;
+    noMapId       += o.noMapId;
+    noPoints      += o.noPoints;
+    loaded        += o.loaded;
+    if (sampleMissingPath.empty()) sampleMissingPath = o.sampleMissingPath;
 }
 
 void ParseXml(const std::string& xmlContent, TacoPack& out)
 {
-    ParseXmlCategories(xmlContent, out);
-    ParseXmlPois(xmlContent, out, nullptr);
+    XmlDocument doc;
+    if (!LoadXmlDocument(xmlContent, doc)) return;
+    ParseDocumentCategories(doc, out);
+    ParseDocumentPois(doc, out, nullptr);
 }
 
 bool LoadTrailBinary(const std::string& absolutePath, Trail& trail)
@@ -429,7 +636,7 @@ bool LoadTrailBinaryMemory(const void* data, size_t size, Trail& trail)
     size -= 4;
     uint32_t fileMapId = 0;
     memcpy(&fileMapId, ptr, 4);
-    trail.mapId = fileMapId;
+    if (trail.mapId == 0) trail.mapId = fileMapId;
     ptr  += 4;
     size -= 4;
     size -= (size % 12);
@@ -450,4 +657,108 @@ bool LoadTrailBinaryMemory(const void* data, size_t size, Trail& trail)
     return true;
 }
 
+void ComputeArcLengths(Trail& trail)
+{
+    const auto& pts = trail.points;
+    trail.arcLengths.assign(pts.size(), 0.f);
+    for (size_t i = 1; i < pts.size(); ++i)
+    {
+        float dx = pts[i].x - pts[i-1].x;
+        float dy = pts[i].y - pts[i-1].y;
+        float dz = pts[i].z - pts[i-1].z;
+        trail.arcLengths[i] = trail.arcLengths[i-1] +
+                              std::sqrt(dx*dx + dy*dy + dz*dz);
+    }
+}
+
+// Douglas-Peucker over points[first..last]: appends the indices kept at the
+// given tolerance, in order, always including first and last.
+static void SimplifyRange(const std::vector<TrailPoint>& pts, size_t first, size_t last,
+                          float tolerance, std::vector<uint32_t>& out)
+{
+    std::vector<char> keep(last - first + 1, 0);
+    keep.front() = keep.back() = 1;
+
+    std::vector<std::pair<size_t, size_t>> stack;
+    if (last > first + 1) stack.push_back({first, last});
+
+    const float tolSq = tolerance * tolerance;
+    while (!stack.empty())
+    {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+
+        const TrailPoint& pa = pts[a];
+        const TrailPoint& pb = pts[b];
+        float abx = pb.x - pa.x, aby = pb.y - pa.y, abz = pb.z - pa.z;
+        float abLenSq = abx*abx + aby*aby + abz*abz;
+
+        // Farthest point from segment a-b.
+        float  worst   = -1.f;
+        size_t worstAt = a;
+        for (size_t i = a + 1; i < b; ++i)
+        {
+            float apx = pts[i].x - pa.x, apy = pts[i].y - pa.y, apz = pts[i].z - pa.z;
+            float t = abLenSq > 0.f
+                    ? std::clamp((apx*abx + apy*aby + apz*abz) / abLenSq, 0.f, 1.f) : 0.f;
+            float dx = apx - t*abx, dy = apy - t*aby, dz = apz - t*abz;
+            float dSq = dx*dx + dy*dy + dz*dz;
+            if (dSq > worst) { worst = dSq; worstAt = i; }
+        }
+
+        if (worst > tolSq)
+        {
+            keep[worstAt - first] = 1;
+            if (worstAt > a + 1) stack.push_back({a, worstAt});
+            if (b > worstAt + 1) stack.push_back({worstAt, b});
+        }
+    }
+
+    for (size_t i = first; i <= last; ++i)
+        if (keep[i - first]) out.push_back((uint32_t)i);
+}
+
+void BuildTrailChunks(Trail& trail)
+{
+    const auto& pts = trail.points;
+    trail.chunks.clear();
+    trail.lodIndices.clear();
+    if (pts.empty()) return;
+
+    auto grow = [](TrailPoint& lo, TrailPoint& hi, const TrailPoint& p)
+    {
+        lo.x = std::min(lo.x, p.x); lo.y = std::min(lo.y, p.y); lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x); hi.y = std::max(hi.y, p.y); hi.z = std::max(hi.z, p.z);
+    };
+
+    const size_t n = pts.size();
+    trail.chunks.reserve((n + kTrailChunkSegments - 1) / kTrailChunkSegments);
+    trail.boundsMin = trail.boundsMax = pts[0];
+
+    // Chunk k starts at point k*S and ends at point (k+1)*S inclusive, so the
+    // segment joining two chunks is drawn exactly once.
+    for (size_t first = 0; first == 0 || first + 1 < n; first += kTrailChunkSegments)
+    {
+        size_t last = std::min(first + kTrailChunkSegments, n - 1);
+
+        TrailChunk chunk;
+        chunk.first     = (uint32_t)first;
+        chunk.count     = (uint32_t)(last - first + 1);
+        chunk.boundsMin = chunk.boundsMax = pts[first];
+        for (size_t i = first + 1; i <= last; ++i)
+            grow(chunk.boundsMin, chunk.boundsMax, pts[i]);
+
+        for (int level = 1; level < kTrailLodLevels; ++level)
+        {
+            chunk.lodFirst[level - 1] = (uint32_t)trail.lodIndices.size();
+            SimplifyRange(pts, first, last, kTrailLodTolerance[level], trail.lodIndices);
+            chunk.lodCount[level - 1] = (uint32_t)trail.lodIndices.size() - chunk.lodFirst[level - 1];
+        }
+
+        grow(trail.boundsMin, trail.boundsMax, chunk.boundsMin);
+        grow(trail.boundsMin, trail.boundsMax, chunk.boundsMax);
+        trail.chunks.push_back(chunk);
+    }
+}
+
 }
@@ -1,12 +1,63 @@
 #pragma once
 #include "TacoPack.h"
+#include <memory>
+#include <unordered_map>
 #include <string>
+#include <vector>
+#include <cstdint>
+
+namespace pugi { class xml_document; }
 
 namespace TacoParser
 {
+
+// Appends MarkerAttribs records to a table, returning the index of an equal
+// record instead when the table already has one.
+class AttribInterner
+{
+public:
+    // Indexes the records already in table.  The table must outlive the
+    // interner and only be appended to through it.
+    explicit AttribInterner(std::vector<MarkerAttribs>& table);
+
+    uint32_t Intern(const MarkerAttribs& a);
+
+private:
+    std::vector<MarkerAttribs>&                table;
+    std::unordered_multimap<size_t, uint32_t>  byHash;
+};
+
+// One pack XML file parsed into a DOM.  Each file is parsed exactly once; the
+// document is kept alive between the category pass and the POI pass so POIs
+// and Trails can reference categories declared in any other file of the pack.
+struct XmlDocument
+{
+    XmlDocument();
+    ~XmlDocument();
+    XmlDocument(XmlDocument&&) noexcept;
+    XmlDocument& operator=(XmlDocument&&) noexcept;
+
+    std::vector<uint8_t>                buffer;   // parsed in place; owned here
+    std::unique_ptr<pugi::xml_document> doc;
+    bool loaded = false;
+};
+
+// Single-file convenience: parses once, then runs both passes on the DOM.
 void ParseXml(const std::string& xmlContent, TacoPack& out);
 
-void ParseXmlCategories(const std::string& xmlContent, TacoPack& out);
+bool LoadXmlDocument(const std::string& xmlContent, XmlDocument& out);
+
+// Parses buffer in place (pugixml load_buffer_inplace) — no copy of the XML.
+// The document takes ownership of the buffer.
+bool LoadXmlDocument(std::vector<uint8_t>&& buffer, XmlDocument& out);
+
+// Pass 1 — merge this document's MarkerCategory tree into out.categories.
+void ParseDocumentCategories(const XmlDocument& doc, TacoPack& out);
+
+// Fingerprint of every MarkerCategory declaration in the document (names and
+// attributes, in document order).  0 if the document declares no categories.
+// Two files with equal fingerprints contribute identically to pass 1.
+uint64_t CategoryHash(const XmlDocument& doc);
 
 struct TrailLoadStats
 {
@@ -18,15 +69,43 @@ struct TrailLoadStats
     int noPoints       = 0;
     int loaded         = 0;
     std::string sampleMissingPath;
+
+    void Merge(const TrailLoadStats& o);
 };
 
-void ParseXmlPois(const std::string& xmlContent, TacoPack& out,
-                  TrailLoadStats* stats = nullptr);
+// Pass 2 — parse POIs and Trails.  Run only after every document of the pack
+// has been through pass 1 so type attributes resolve against the full tree.
+// Trails are emitted with trailDataFile set but no points; the caller owns
+// the pack's files and fills them in via LoadTrailBinaryMemory.
+// Resolved attributes are interned into out.attribs.
+void ParseDocumentPois(const XmlDocument& doc, TacoPack& out,
+                       TrailLoadStats* stats = nullptr);
+
+// Same as above, writing into separate output vectors.  categories is only
+// read, so several documents of one pack may be resolved concurrently.  The
+// markers' attrib indices refer to attribs, which the caller merges into the
+// pack's table afterwards.
+void ParseDocumentPois(const XmlDocument& doc,
+                       const std::vector<MarkerCategory>& categories,
+                       std::vector<Poi>& pois, std::vector<Trail>& trails,
+                       std::vector<MarkerAttribs>& attribs,
+                       TrailLoadStats* stats = nullptr);
 
 bool LoadTrailBinary(const std::string& absolutePath, Trail& trail);
 
+// Reads a .trl image.  A MapID already set on the trail (from the XML node)
+// takes precedence over the one stored in the file.
 bool LoadTrailBinaryMemory(const void* data, size_t size, Trail& trail);
 
+// Precompute cumulative arc lengths so the renderer can look up stable
+// world-anchored UV coordinates without per-frame accumulation.
+void ComputeArcLengths(Trail& trail);
+
+// Split the trail into chunks of kTrailChunkSegments segments and compute
+// their bounding boxes (and the trail's) and simplified LOD levels.
+constexpr uint32_t kTrailChunkSegments = 64;
+void BuildTrailChunks(Trail& trail);
+
 std::string NormalisePath(const std::string& raw);
 
 }
@@ -0,0 +1,150 @@
+#include "TaskPool.h"
+
+// Index of the calling thread's deque in the pool it belongs to (-1 outside).
+static thread_local const TaskPool* t_Pool        = nullptr;
+static thread_local int             t_WorkerIndex = -1;
+
+TaskPool::TaskPool(unsigned threadCount)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 4;
+
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.push_back(std::make_unique<Worker>());
+
+    threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.emplace_back(&TaskPool::WorkerMain, this, i);
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+        if (t.joinable()) t.join();
+}
+
+void TaskPool::Submit(TaskGroup& group, Task task)
+{
+    group.pending.fetch_add(1);
+
+    unsigned target = (t_Pool == this && t_WorkerIndex >= 0)
+                    ? (unsigned)t_WorkerIndex
+                    : nextQueue.fetch_add(1) % (unsigned)workers.size();
+    {
+        Worker& w = *workers[target];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.items.push_back({std::move(task), &group});
+    }
+    queued.fetch_add(1);
+
+    // Taking the lock orders this push against a sleeper's predicate check.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+void TaskPool::Wait(TaskGroup& group)
+{
+    int self = (t_Pool == this) ? t_WorkerIndex : -1;
+
+    while (group.pending.load() > 0)
+    {
+        if (TryRunOne(self)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&]{ return group.pending.load() == 0 || queued.load() > 0; });
+    }
+
+    // The error was stored before its task's pending decrement.
+    if (group.failed.load())
+    {
+        std::exception_ptr error = std::move(group.error);
+        group.error  = nullptr;
+        group.failed = false;
+        std::rethrow_exception(error);
+    }
+}
+
+bool TaskPool::TryRunOne(int self)
+{
+    Item item;
+    bool found = false;
+
+    // Own deque first, newest task (LIFO keeps nested work cache-warm).
+    if (self >= 0)
+    {
+        Worker& w = *workers[self];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.items.empty())
+        {
+            item = std::move(w.items.back());
+            w.items.pop_back();
+            found = true;
+        }
+    }
+
+    // Steal the oldest task from someone else.
+    if (!found)
+    {
+        size_t n     = workers.size();
+        size_t start = (self >= 0) ? (size_t)self + 1 : 0;
+        for (size_t k = 0; k < n && !found; ++k)
+        {
+            size_t idx = (start + k) % n;
+            if ((int)idx == self) continue;
+
+            Worker& w = *workers[idx];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.items.empty())
+            {
+                item = std::move(w.items.front());
+                w.items.pop_front();
+                found = true;
+            }
+        }
+    }
+
+    if (!found) return false;
+
+    queued.fetch_sub(1);
+    Run(item);
+    return true;
+}
+
+void TaskPool::Run(Item& item)
+{
+    // A failed task must not wedge its group: it still counts as done, and
+    // the group's first exception is handed to Wait.
+    try { item.task(); }
+    catch (...)
+    {
+        if (!item.group->failed.exchange(true))
+            item.group->error = std::current_exception();
+    }
+
+    if (item.group->pending.fetch_sub(1) == 1)
+    {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_all();
+    }
+}
+
+void TaskPool::WorkerMain(unsigned index)
+{
+    t_Pool        = this;
+    t_WorkerIndex = (int)index;
+
+    for (;;)
+    {
+        if (TryRunOne((int)index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&]{ return stopping.load() || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
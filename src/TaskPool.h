@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TaskPool
+//
+// Small work-stealing thread pool used by the pack loader.
+//   •  Each worker owns a deque: it pushes / pops its own work at the back and
+//      steals from the front of the other workers' deques when it runs dry.
+//   •  Tasks submitted from outside the pool are spread round-robin.
+//   •  Tasks are tracked by a TaskGroup.  Wait() executes queued tasks while
+//      the group is pending, so a task may safely submit sub-tasks and wait on
+//      them without tying up its worker.
+// ─────────────────────────────────────────────────────────────────────────────
+class TaskPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // If tasks of a group throw, the first exception is kept (the others are
+    // dropped) and rethrown by Wait once the whole group has finished.
+    struct TaskGroup
+    {
+        std::atomic<int>   pending{0};
+        std::atomic<bool>  failed{false};
+        std::exception_ptr error;          // set by the first failing task
+    };
+
+    // threads == 0 → one worker per hardware thread.
+    explicit TaskPool(unsigned threads = 0);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&)            = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void Submit(TaskGroup& group, Task task);
+
+    // Blocks until every task of the group has finished, running queued tasks
+    // (of any group) in the meantime, then rethrows the group's first
+    // exception, if any.
+    void Wait(TaskGroup& group);
+
+    unsigned ThreadCount() const { return (unsigned)threads.size(); }
+
+private:
+    struct Item
+    {
+        Task       task;
+        TaskGroup* group = nullptr;
+    };
+
+    struct Worker
+    {
+        std::mutex       mutex;
+        std::deque<Item> items;
+    };
+
+    void WorkerMain(unsigned index);
+    bool TryRunOne(int self);
+    void Run(Item& item);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread>             threads;
+
+    std::mutex              sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int>        queued{0};
+    std::atomic<unsigned>   nextQueue{0};
+    std::atomic<bool>       stopping{false};
+};
@@ -3,6 +3,7 @@
 #include "Settings.h"
 #include "PackManager.h"
 #include "TacoPack.h"
+#include "Profiler.h"
 
 #include <imgui.h>
 #include <string>
@@ -31,7 +32,7 @@ static bool DrawCategoryTree(std::vector<MarkerCategory>& cats,
         }
         if (ImGui::Checkbox(("##cb_" + cat.name + std::to_string(depth)).c_str(), &nodeCb))
         {
-            cat.enabled = nodeCb;
+            PackManager::SetCategoryEnabled(cat, nodeCb);
             changed = true;
         }
         if (!parentEnabled) ImGui::PopStyleVar();
@@ -45,7 +46,7 @@ static bool DrawCategoryTree(std::vector<MarkerCategory>& cats,
             if (cat.expanded) flags |= ImGuiTreeNodeFlags_DefaultOpen;
 
             bool open = ImGui::TreeNodeEx(label.c_str(), flags);
-            cat.expanded = open;
+            if (open != cat.expanded) PackManager::SetCategoryExpanded(cat, open);
             if (open)
             {
                 if (DrawCategoryTree(cat.children, nodeEnabled, depth + 1))
@@ -61,6 +62,42 @@ static bool DrawCategoryTree(std::vector<MarkerCategory>& cats,
     return changed;
 }
 
+// Summary of PackManager::LastLoadReport(): totals, then packs slowest first.
+static void DrawLoadReport()
+{
+    auto report = PackManager::LastLoadReport();
+    if (!report) return;
+
+    if (!ImGui::TreeNode("Last load##load_report")) return;
+
+    constexpr double kMiB = 1024.0 * 1024.0;
+    ImGui::TextDisabled("%s  —  %.0f ms, private memory %.0f MiB, peak %.0f MiB",
+                        report->finishedAt.c_str(), report->wallMs,
+                        report->memStart / kMiB, report->memPeak / kMiB);
+
+    std::vector<const LoadProfile::PackReport*> packs;
+    for (const auto& pack : report->packs) packs.push_back(&pack);
+    std::sort(packs.begin(), packs.end(),
+        [](const LoadProfile::PackReport* a, const LoadProfile::PackReport* b)
+        { return a->wallMs > b->wallMs; });
+
+    for (const LoadProfile::PackReport* pack : packs)
+    {
+        LoadProfile::Stage slowest = pack->Slowest();
+        if (slowest == LoadProfile::Stage::Count)
+        {
+            ImGui::Text("%s: %.0f ms (%s)", pack->name.c_str(), pack->wallMs, pack->result.c_str());
+            continue;
+        }
+        ImGui::Text("%s: %.0f ms (%s), most in %s: %.0f ms",
+                    pack->name.c_str(), pack->wallMs, pack->result.c_str(),
+                    LoadProfile::StageName(slowest), pack->stages[(size_t)slowest].ms);
+    }
+    ImGui::TextDisabled("Every stage of every pack: load_profile.json in the addon folder.");
+
+    ImGui::TreePop();
+}
+
 void UI::RenderWindow()
 {
     if (!g_Settings.ShowWindow) return;
@@ -110,6 +147,9 @@ void UI::RenderWindow()
     mChanged |= ImGui::Checkbox("Show Trails", &g_Settings.RenderTrails);
     if (mChanged) g_Settings.Save();
 
+    if (!PackManager::IsLoading())
+        DrawLoadReport();
+
     ImGui::Separator();
 
     ImGui::BeginChild("##pack_list", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
@@ -129,7 +169,7 @@ void UI::RenderWindow()
         bool packEnabled = pack.enabled;
         if (ImGui::Checkbox(("##packena_" + pack.name).c_str(), &packEnabled))
         {
-            pack.enabled = packEnabled;
+            PackManager::SetPackEnabled(pack, packEnabled);
             packChanged  = true;
         }
         ImGui::SameLine();
@@ -151,7 +191,7 @@ void UI::RenderWindow()
         }
 
         if (packChanged)
-            PackManager::SaveCategoryState();
+            PackManager::OnCategoriesChanged(pack);
     }
 
     ImGui::EndChild();
@@ -213,6 +253,27 @@ void UI::RenderOptions()
     changed |= ImGui::Checkbox("Debug overlay", &g_Settings.ShowDebugInfo);
     if (ImGui::IsItemHovered())
         ImGui::SetTooltip("Show marker/trail count and pack status on screen");
+    if (g_Settings.ShowDebugInfo)
+    {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Export frame timings") && APIDefs)
+        {
+            std::string path = PackManager::AddonDataDir() + "\\frame_timings.csv";
+            bool ok = Profiler::ExportCsv(path);
+            APIDefs->Log(ok ? LOGL_INFO : LOGL_WARNING, "Pathing",
+                         ((ok ? "Frame timings written to " : "Could not write ") + path).c_str());
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Write the last %d frames' stage timings and culling counts to frame_timings.csv in the addon folder.",
+                              (int)Profiler::kHistory);
+    }
+    changed |= ImGui::SliderFloat("Texture load budget (ms)##texbud",
+                                  &g_Settings.TextureBudgetMs, 0.5f, 8.f, "%.1f");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Time per frame spent registering textures with the game. Only the textures the current map's enabled markers and trails use are registered, when the map is entered.");
+    changed |= ImGui::Checkbox("Auto-reload packs##autorl", &g_Settings.AutoReloadPacks);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Watch the packs folder and reload packs that change. Only modified files inside a pack are parsed again.");
     ImGui::Spacing();
 
     ImGui::Separator();
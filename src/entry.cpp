@@ -138,6 +138,7 @@ static void AddonUnload()
 
     APIDefs->GUI_Deregister(Render);
     APIDefs->GUI_Deregister(RenderOptions);
+    MarkerRenderer::Shutdown();
 
     APIDefs->InputBinds_Deregister("KB_PATHING_TOGGLEWIN");
     APIDefs->InputBinds_Deregister("KB_PATHING_TOGGLEMARKERS");
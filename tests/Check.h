@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Check
+//
+// The little the test executables need: CHECK records a failure with its
+// location and carries on, Result() turns the count into main's exit code
+// (CTest treats non-zero as a failed test).  Rng makes the inputs repeatable.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace Check
+{
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool That(bool ok, const char* what, const char* file, int line)
+{
+    if (!ok)
+    {
+        ++Failures();
+        printf("%s:%d: check failed: %s\n", file, line, what);
+    }
+    return ok;
+}
+
+// Small deterministic generator for test inputs.
+struct Rng
+{
+    uint64_t state;
+    uint32_t Next()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return (uint32_t)(state >> 33);
+    }
+    float Uniform(float lo, float hi) { return lo + (hi - lo) * (float)Next() / 2147483648.f; }
+};
+
+inline int Result(const char* test)
+{
+    if (Failures()) printf("%s: %d check(s) failed\n", test, Failures());
+    else            printf("%s: ok\n", test);
+    return Failures() ? 1 : 0;
+}
+
+} // namespace Check
+
+#define CHECK(expr) Check::That((expr), #expr, __FILE__, __LINE__)
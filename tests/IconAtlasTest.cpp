@@ -0,0 +1,112 @@
+// Icon atlas: icons land inside their page, don't overlap, and every pixel of
+// the padded rectangle holds the nearest pixel of the icon; icons too large
+// for a page are left out; a page survives its PNG round trip.
+#include "Check.h"
+
+#include "IconAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // Random RGBA images up to 96 px, every 50th up to 400 px wide (too
+    // large to pack).
+    std::vector<IconAtlas::Image> RandomImages(size_t count)
+    {
+        Check::Rng rng{7};
+        std::vector<IconAtlas::Image> images(count);
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            IconAtlas::Image& img = images[i];
+            img.width  = 1 + (int)(rng.Next() % (i % 50 == 49 ? 400 : 96));
+            img.height = 1 + (int)(rng.Next() % 96);
+            img.rgba.resize((size_t)img.width * img.height * 4);
+            for (size_t p = 0; p < img.rgba.size(); ++p) img.rgba[p] = (uint8_t)rng.Next();
+        }
+        return images;
+    }
+
+    // Stops at the first broken icon; one failure is enough to go on.
+    void CheckPlacements(const std::vector<IconAtlas::Image>& images,
+                         const std::vector<IconAtlas::Page>& pages,
+                         const std::vector<IconAtlas::Placement>& placements, size_t packed)
+    {
+        std::vector<std::vector<uint32_t>> owner(pages.size());
+        for (size_t p = 0; p < pages.size(); ++p)
+            owner[p].assign((size_t)pages[p].size * pages[p].size, 0xFFFFFFFFu);
+
+        size_t placed = 0;
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            const IconAtlas::Image&     img = images[i];
+            const IconAtlas::Placement& pl  = placements[i];
+            const bool tooLarge = img.width > IconAtlas::kMaxIconSize ||
+                                  img.height > IconAtlas::kMaxIconSize;
+            if (pl.page == IconAtlas::kNoPage)
+            {
+                if (!CHECK(tooLarge)) return;
+                continue;
+            }
+            if (!CHECK(!tooLarge && pl.page < pages.size())) return;
+            ++placed;
+
+            const IconAtlas::Page& page = pages[pl.page];
+            const int x0 = (int)std::lround(pl.u0 * page.size);
+            const int y0 = (int)std::lround(pl.v0 * page.size);
+            if (!CHECK(std::lround(pl.u1 * page.size) - x0 == img.width &&
+                       std::lround(pl.v1 * page.size) - y0 == img.height))
+                return;
+
+            const int pad = IconAtlas::kPadding;
+            if (!CHECK(x0 - pad >= 0 && y0 - pad >= 0 &&
+                       x0 + img.width + pad <= page.size && y0 + img.height + pad <= page.size))
+                return;
+
+            for (int y = y0 - pad; y < y0 + img.height + pad; ++y)
+            {
+                for (int x = x0 - pad; x < x0 + img.width + pad; ++x)
+                {
+                    uint32_t& o = owner[pl.page][(size_t)y * page.size + x];
+                    if (!CHECK(o == 0xFFFFFFFFu)) return;    // overlaps icon o
+                    o = (uint32_t)i;
+
+                    const int sx = std::clamp(x - x0, 0, img.width - 1);
+                    const int sy = std::clamp(y - y0, 0, img.height - 1);
+                    if (!CHECK(memcmp(&page.rgba[((size_t)y * page.size + x) * 4],
+                                      &img.rgba[((size_t)sy * img.width + sx) * 4], 4) == 0))
+                        return;
+                }
+            }
+        }
+        CHECK(placed == packed);
+    }
+}
+
+int main()
+{
+    const std::vector<IconAtlas::Image> images = RandomImages(300);
+
+    std::vector<IconAtlas::Page>      pages;
+    std::vector<IconAtlas::Placement> placements;
+    const size_t packed = IconAtlas::Pack(images, pages, placements);
+    if (CHECK(placements.size() == images.size()))
+        CheckPlacements(images, pages, placements, packed);
+    CHECK(!pages.empty());
+
+    // Every page must decode back to itself.
+    for (const IconAtlas::Page& page : pages)
+    {
+        std::vector<uint8_t> png;
+        IconAtlas::Image     decoded;
+        CHECK(IconAtlas::EncodePng(page, png));
+        CHECK(IconAtlas::Decode(png.data(), png.size(), decoded));
+        CHECK(decoded.width == page.size && decoded.height == page.size && decoded.rgba == page.rgba);
+    }
+
+    printf("icon_atlas_test: %zu of %zu icons on %zu page(s)\n", packed, images.size(), pages.size());
+    return Check::Result("icon_atlas_test");
+}
@@ -0,0 +1,248 @@
+// PackCache round trip: a pack parsed from a .taco by the loader's XML path
+// (PackLoader), saved to its cache and loaded back must be exactly that pack —
+// every category, attribute record, POI, trail point and arc length, the
+// sources and, once both are indexed, the map index.  Reloading an unchanged
+// archive carries every file over.  A touched archive with the same content
+// still hits; damaged cache files must be rejected.
+#include "Check.h"
+#include "SyntheticPack.h"
+
+#include "LoadProfile.h"
+#include "PackArchive.h"
+#include "PackCache.h"
+#include "PackLoader.h"
+#include "TacoParser.h"
+#include "TaskPool.h"
+
+#include <miniz.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool SameBits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+    bool SamePoint(const TrailPoint& a, const TrailPoint& b)
+    {
+        return SameBits(a.x, b.x) && SameBits(a.y, b.y) && SameBits(a.z, b.z);
+    }
+
+    template <typename T, typename Eq>
+    void CheckEach(const char* what, const std::vector<T>& a, const std::vector<T>& b, Eq same)
+    {
+        if (a.size() != b.size())
+        {
+            Check::That(false, (std::string(what) + ": sizes differ").c_str(), __FILE__, __LINE__);
+            return;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (same(a[i], b[i])) continue;
+            Check::That(false, (std::string(what) + " [" + std::to_string(i) + "] differs").c_str(),
+                        __FILE__, __LINE__);
+            return;
+        }
+    }
+
+    bool SameCategory(const MarkerCategory& a, const MarkerCategory& b)
+    {
+        if (a.name != b.name || a.displayName != b.displayName || a.attribs != b.attribs ||
+            a.enabled != b.enabled || a.expanded != b.expanded || a.index != b.index ||
+            a.children.size() != b.children.size())
+            return false;
+        for (size_t i = 0; i < a.children.size(); ++i)
+            if (!SameCategory(a.children[i], b.children[i])) return false;
+        return true;
+    }
+
+    bool SameChunk(const TrailChunk& a, const TrailChunk& b)
+    {
+        if (a.first != b.first || a.count != b.count ||
+            !SamePoint(a.boundsMin, b.boundsMin) || !SamePoint(a.boundsMax, b.boundsMax))
+            return false;
+        for (int l = 0; l < kTrailLodLevels - 1; ++l)
+            if (a.lodFirst[l] != b.lodFirst[l] || a.lodCount[l] != b.lodCount[l]) return false;
+        return true;
+    }
+
+    bool SameTrail(const Trail& a, const Trail& b)
+    {
+        if (a.mapId != b.mapId || a.source != b.source || a.type != b.type ||
+            a.trailDataFile != b.trailDataFile || a.category != b.category ||
+            a.attrib != b.attrib || a.texSlot != b.texSlot ||
+            a.points.size() != b.points.size() || a.arcLengths.size() != b.arcLengths.size() ||
+            a.chunks.size() != b.chunks.size() || a.lodIndices != b.lodIndices ||
+            !SamePoint(a.boundsMin, b.boundsMin) || !SamePoint(a.boundsMax, b.boundsMax))
+            return false;
+        for (size_t i = 0; i < a.points.size(); ++i)
+            if (!SamePoint(a.points[i], b.points[i])) return false;
+        for (size_t i = 0; i < a.arcLengths.size(); ++i)
+            if (!SameBits(a.arcLengths[i], b.arcLengths[i])) return false;
+        for (size_t i = 0; i < a.chunks.size(); ++i)
+            if (!SameChunk(a.chunks[i], b.chunks[i])) return false;
+        return true;
+    }
+
+    // Writes the generated files as a .taco archive, as taco_gen does.
+    bool WriteTaco(const std::string& path, const std::vector<SyntheticPack::File>& files)
+    {
+        mz_zip_archive zip{};
+        if (!mz_zip_writer_init_file(&zip, path.c_str(), 0)) return false;
+        bool ok = true;
+        for (const auto& file : files)
+            ok = ok && mz_zip_writer_add_mem(&zip, file.name.c_str(), file.data.data(),
+                                             file.data.size(), MZ_DEFAULT_LEVEL);
+        ok = ok && mz_zip_writer_finalize_archive(&zip);
+        mz_zip_writer_end(&zip);
+        return ok;
+    }
+
+    // What LoadPack does to a pack after parsing or loading it.  Trail chunks
+    // come from ParsePack or the cache.
+    void IndexPack(TacoPack& pack)
+    {
+        pack.IndexCategories();
+        pack.BuildMapIndex();
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream f(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+    }
+
+    void WriteFile(const std::string& path, const std::vector<uint8_t>& data, size_t size)
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)size);
+    }
+}
+
+int main()
+{
+    SyntheticPack::Options options;
+    options.maps           = 3;
+    options.poisPerMap     = 500;
+    options.trailsPerMap   = 4;
+    options.pointsPerTrail = 300;
+    options.categories     = 4;
+    options.depth          = 3;
+    options.icons          = 8;
+
+    std::vector<SyntheticPack::File> files;
+    SyntheticPack::Generate(options, files);
+
+    const std::string tacoPath = "pack_cache_test.taco";
+    CHECK(WriteTaco(tacoPath, files));
+    PackArchive archive;
+    CHECK(archive.Open(tacoPath));
+
+    // The loader's XML path, on a pool as in the addon.
+    TaskPool                 pool(4);
+    LoadProfile::PackProfile prof;
+    PackLoader::ParseStats   stats;
+    TacoPack parsed;
+    PackLoader::ParsePack(pool, archive, nullptr, parsed, prof, stats);
+    PackLoader::RecordTrailCrcs(archive, parsed);
+    CHECK(parsed.pois.size()   == (size_t)options.maps * options.poisPerMap);
+    CHECK(parsed.trails.size() == (size_t)options.maps * options.trailsPerMap);
+    CHECK(stats.reparsed == stats.fileCount);
+    CHECK(stats.trails.loaded == (int)parsed.trails.size());
+    for (const auto& trail : parsed.trails)
+        CHECK(!trail.chunks.empty() && !trail.lodIndices.empty());
+
+    // Reloading the same archive against it carries every file over unparsed.
+    const PackLoader::PrevPack prev = PackLoader::SnapshotPrev(parsed);
+    PackLoader::ParseStats     reloadStats;
+    TacoPack reloaded;
+    PackLoader::ParsePack(pool, archive, &prev, reloaded, prof, reloadStats);
+    CHECK(reloadStats.fileCount == stats.fileCount);
+    CHECK(reloadStats.reparsed  == 0);
+    CheckEach("reloaded pois", parsed.pois, reloaded.pois, [](const Poi& a, const Poi& b)
+    {
+        return a.guid == b.guid && a.source == b.source && a.attrib == b.attrib;
+    });
+    CheckEach("reloaded trails", parsed.trails, reloaded.trails, SameTrail);
+
+    const std::string     path = "pack_cache_test.pcache";
+    const PackCache::Key  key{ 12345, 67890, 0xC0FFEEull };
+    CHECK(PackCache::Save(path, key, parsed));
+
+    TacoPack cached;
+    CHECK(PackCache::Load(path, key, cached));
+
+    IndexPack(parsed);
+    IndexPack(cached);
+
+    CheckEach("sources", parsed.sources, cached.sources, [](const PackSource& a, const PackSource& b)
+    {
+        return a.file == b.file && a.crc32 == b.crc32 && a.categoryHash == b.categoryHash;
+    });
+    CheckEach("categories", parsed.categories, cached.categories, SameCategory);
+    CheckEach("attribs", parsed.attribs, cached.attribs,
+              [](const MarkerAttribs& a, const MarkerAttribs& b) { return a == b; });
+    CheckEach("pois", parsed.pois, cached.pois, [](const Poi& a, const Poi& b)
+    {
+        return a.mapId == b.mapId && a.source == b.source && SameBits(a.x, b.x) &&
+               SameBits(a.y, b.y) && SameBits(a.z, b.z) && a.type == b.type &&
+               a.guid == b.guid && a.category == b.category && a.attrib == b.attrib;
+    });
+    CheckEach("trails", parsed.trails, cached.trails, SameTrail);
+    CheckEach("mapIndex", parsed.mapIndex, cached.mapIndex, [](const MapRange& a, const MapRange& b)
+    {
+        return a.mapId == b.mapId && a.poiBegin == b.poiBegin && a.poiEnd == b.poiEnd &&
+               a.trailBegin == b.trailBegin && a.trailEnd == b.trailEnd;
+    });
+    CHECK(parsed.categoryCount == cached.categoryCount);
+    CHECK(parsed.enabledBits   == cached.enabledBits);
+
+    // A different key is a miss.
+    TacoPack miss;
+    CHECK(!PackCache::Load(path, PackCache::Key{ 12345, 67890, 1 }, miss));
+    TacoPack resized;
+    CHECK(!PackCache::Load(path, PackCache::Key{ 12346, 67890, 0xC0FFEEull }, resized));
+
+    // A touched archive (new time, same content) still hits, and the cache's
+    // stored time follows it.  The time follows magic, version and size.
+    const PackCache::Key touchedKey{ 12345, 99999, 0xC0FFEEull };
+    TacoPack touched;
+    CHECK(PackCache::Load(path, touchedKey, touched));
+    CheckEach("touched pois", cached.pois, touched.pois, [](const Poi& a, const Poi& b)
+    {
+        return a.guid == b.guid && SameBits(a.x, b.x) && SameBits(a.y, b.y) && SameBits(a.z, b.z);
+    });
+    uint64_t storedMtime = 0;
+    const std::vector<uint8_t> restamped = ReadFile(path);
+    CHECK(restamped.size() > 4 + 4 + 8 + 8);
+    if (restamped.size() > 4 + 4 + 8 + 8)
+        memcpy(&storedMtime, restamped.data() + 4 + 4 + 8, sizeof(storedMtime));
+    CHECK(storedMtime == touchedKey.archiveMtime);
+
+    // Damaged files are rejected, never trusted.
+    const std::vector<uint8_t> image = ReadFile(path);
+    CHECK(image.size() > 64);
+    for (size_t size : { (size_t)16, image.size() / 3, image.size() / 2, image.size() - 1 })
+    {
+        WriteFile(path, image, size);
+        TacoPack damaged;
+        CHECK(!PackCache::Load(path, key, damaged));
+    }
+
+    // A root category count far beyond the records in the file.  The count
+    // follows magic, version and the three key fields in the header.
+    std::vector<uint8_t> bogus = image;
+    const uint32_t hugeCount = 0xF0000000u;
+    memcpy(bogus.data() + 4 + 4 + 3 * 8, &hugeCount, sizeof(hugeCount));
+    WriteFile(path, bogus, bogus.size());
+    TacoPack corrupt;
+    CHECK(!PackCache::Load(path, key, corrupt));
+
+    archive.Close();
+    std::remove(path.c_str());
+    std::remove(tacoPath.c_str());
+    return Check::Result("pack_cache_test");
+}
@@ -0,0 +1,85 @@
+// Batched projection: whichever path Project() picks on this CPU must match
+// ProjectScalar bit for bit, and a point is visible exactly when
+// WorldToScreen accepts it within maxDist.  Batch sizes cover the vector
+// paths' remainder loop and batches smaller than one vector.
+#include "Check.h"
+
+#include "Projection.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace Math;
+
+namespace
+{
+    bool SameBits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+    // sx / sy / dist / ppu are only compared where the point is visible.
+    bool CheckBatch(const ProjectionParams& params, size_t size, uint64_t seed, size_t& visible)
+    {
+        Check::Rng rng{ seed };
+        PointBatch simd, scalar;
+        simd.Resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            simd.x[i] = rng.Uniform(-2000.f, 2000.f);
+            simd.y[i] = rng.Uniform(-100.f, 200.f);
+            simd.z[i] = rng.Uniform(-2000.f, 2000.f);
+        }
+        scalar.Resize(size);
+        scalar.x = simd.x; scalar.y = simd.y; scalar.z = simd.z;
+
+        Project(params, simd);
+        ProjectScalar(params, scalar);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (!CHECK(simd.visible[i] == scalar.visible[i])) return false;
+
+            float sx, sy, depth;
+            const Vec3 p{ scalar.x[i], scalar.y[i], scalar.z[i] };
+            const bool expected = WorldToScreen(p, params.viewProj, params.screenW, params.screenH,
+                                                sx, sy, depth) &&
+                                  std::sqrt(DistSq(p, params.camPos)) <= params.maxDist;
+            if (!CHECK(scalar.visible[i] == (expected ? 1 : 0))) return false;
+
+            if (!scalar.visible[i]) continue;
+            ++visible;
+            if (!CHECK(SameBits(simd.sx[i], scalar.sx[i]) && SameBits(simd.sy[i], scalar.sy[i]) &&
+                       SameBits(simd.dist[i], scalar.dist[i]) && SameBits(simd.ppu[i], scalar.ppu[i])))
+                return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    struct View { Vec3 position, front; };
+    const View views[] = {
+        { {  10.f,  40.f,  -25.f }, {  0.3f, -0.2f,  1.f } },
+        { {   0.f, 900.f,    0.f }, {  0.0f, -1.f,   0.05f } },   // looking almost straight down
+        { { 500.f,   5.f, -800.f }, { -1.0f,  0.1f, -0.4f } },
+    };
+    const float  w = 1920.f, h = 1080.f, fovY = 1.0f;
+    const size_t sizes[] = { 0, 1, 3, 7, 8, 9, 100003 };
+
+    size_t visible = 0, total = 0;
+    uint64_t seed = 42;
+    for (const View& v : views)
+    {
+        const Mat4 viewProj = Perspective(fovY, w / h, 0.1f, 5000.f) *
+                              LookAt(v.position, v.front, { 0.f, 1.f, 0.f });
+        const auto params = ProjectionParams::Make(viewProj, v.position, w, h, fovY, 1500.f);
+        for (size_t size : sizes)
+        {
+            CheckBatch(params, size, seed++, visible);
+            total += size;
+        }
+    }
+
+    printf("projection_test: %s path, %zu of %zu points visible\n", ProjectPathName(), visible, total);
+    return Check::Result("projection_test");
+}